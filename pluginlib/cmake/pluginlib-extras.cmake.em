@@ -0,0 +1,11 @@
+# generated from pluginlib/cmake/pluginlib-extras.cmake.em
+
+@[if DEVELSPACE]@
+set(pluginlib_SCRIPTS_DIR "@(CMAKE_CURRENT_SOURCE_DIR)/scripts")
+set(pluginlib_CMAKE_DIR "@(CMAKE_CURRENT_SOURCE_DIR)/cmake")
+@[else]@
+set(pluginlib_SCRIPTS_DIR "${pluginlib_DIR}/../../../@(CATKIN_PACKAGE_BIN_DESTINATION)")
+set(pluginlib_CMAKE_DIR "${pluginlib_DIR}")
+@[end if]@
+
+include("${pluginlib_CMAKE_DIR}/pluginlib_compile_manifests.cmake")
@@ -0,0 +1,42 @@
+include(CMakeParseArguments)
+
+#
+# Compile plugin description files into C++ tables of their classes.
+#
+# A ClassLoader in a binary linking the generated sources takes the classes of these files from
+# the tables instead of reading and parsing the files at runtime. Add the sources to the
+# executable or shared library creating the ClassLoader, not to the plugin library itself: the
+# tables register themselves when the binary holding them is loaded.
+#
+# :param output_variable: the variable to store the paths of the generated sources in
+# :param ARGN: the plugin description files, e.g. the ones exported in package.xml
+# :param PACKAGE: the package exporting the files, defaults to PROJECT_NAME
+#
+# @public
+#
+function(pluginlib_compile_manifests output_variable)
+  cmake_parse_arguments(ARG "" "PACKAGE" "" ${ARGN})
+  if(NOT ARG_PACKAGE)
+    set(ARG_PACKAGE ${PROJECT_NAME})
+  endif()
+  if(NOT ARG_UNPARSED_ARGUMENTS)
+    message(FATAL_ERROR "pluginlib_compile_manifests() called without plugin description files")
+  endif()
+
+  set(generator "${pluginlib_SCRIPTS_DIR}/pluginlib_compile_manifest.py")
+  set(sources "")
+  foreach(plugin_xml ${ARG_UNPARSED_ARGUMENTS})
+    get_filename_component(plugin_xml_path "${plugin_xml}" ABSOLUTE)
+    file(RELATIVE_PATH relative_path "${PROJECT_SOURCE_DIR}" "${plugin_xml_path}")
+    string(REGEX REPLACE "[^A-Za-z0-9_]" "_" source_name "${ARG_PACKAGE}_${relative_path}")
+    set(source "${CMAKE_CURRENT_BINARY_DIR}/pluginlib_manifests/${source_name}.cpp")
+    add_custom_command(OUTPUT "${source}"
+      COMMAND ${CMAKE_COMMAND} -E make_directory "${CMAKE_CURRENT_BINARY_DIR}/pluginlib_manifests"
+      COMMAND ${PYTHON_EXECUTABLE} "${generator}"
+        "${plugin_xml_path}" "${ARG_PACKAGE}" "${relative_path}" "${source}"
+      DEPENDS "${plugin_xml_path}" "${generator}"
+      COMMENT "Compiling plugin description file ${relative_path}")
+    list(APPEND sources "${source}")
+  endforeach()
+  set(${output_variable} ${sources} PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,7 @@
+#!/usr/bin/env sh
+# generated from pluginlib/env-hooks/50.pluginlib_index.sh
+
+# use the plugin index written by `pluginlib_index --workspace <prefix>`, unless one is set
+if [ -z "$PLUGINLIB_INDEX" ] && [ -f "$CATKIN_ENV_HOOK_WORKSPACE/share/pluginlib/plugin_index" ]; then
+  export PLUGINLIB_INDEX="$CATKIN_ENV_HOOK_WORKSPACE/share/pluginlib/plugin_index"
+fi
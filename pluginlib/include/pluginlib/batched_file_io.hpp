@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__BATCHED_FILE_IO_HPP_
+#define PLUGINLIB__BATCHED_FILE_IO_HPP_
+
+#include <string>
+#include <vector>
+
+#include "boost/cstdint.hpp"
+#include "pluginlib/plugin_manifest.hpp"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+// Defined along with the statx, openat and read operations
+#if defined(IORING_FEAT_RW_CUR_POS)
+#define PLUGINLIB_HAS_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifdef PLUGINLIB_HAS_IO_URING
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#endif
+
+namespace pluginlib
+{
+
+/// Stats and reads many files with few system calls, by submitting them to io_uring in batches.
+/**
+ * Meant for filesystems where every system call is expensive, such as overlayfs in containers.
+ * Requires Linux 5.6 or later; isAvailable() is false on other systems, where io_uring is
+ * disabled, e.g. by a seccomp profile, or if setting up the ring fails. Every method reports
+ * which files it could not handle, for the caller to fall back to ordinary system calls.
+ */
+class BatchedFileIO
+{
+public:
+  /// Set up a ring for batches of the given number of operations.
+  explicit BatchedFileIO(unsigned int batch_size = 256)
+  : fd_(-1)
+  {
+#ifdef PLUGINLIB_HAS_IO_URING
+    ring_ = MAP_FAILED;
+    ring_size_ = 0;
+    sqes_ = NULL;
+    sqes_size_ = 0;
+    setUp(batch_size);
+#else
+    (void)batch_size;
+#endif
+  }
+
+  ~BatchedFileIO()
+  {
+    tearDown();
+  }
+
+  bool isAvailable() const
+  {
+    return fd_ >= 0;
+  }
+
+  /// Stat files like ManifestStamp::of(), which a missing file yields a zero stamp for.
+  /**
+   * \param handled Set to whether the stamp of each file was taken
+   * \return false if nothing was done, e.g. because io_uring is not available
+   */
+  bool stamp(
+    const std::vector<std::string> & paths, std::vector<ManifestStamp> & stamps,
+    std::vector<bool> & handled)
+  {
+    stamps.assign(paths.size(), ManifestStamp());
+    handled.assign(paths.size(), false);
+#ifdef PLUGINLIB_HAS_IO_URING
+    if (!isAvailable()) {
+      return false;
+    }
+    std::vector<struct statx> buffers(paths.size());
+    std::vector<io_uring_sqe> requests(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      io_uring_sqe & request = requests[i];
+      std::memset(&request, 0, sizeof(request));
+      request.opcode = IORING_OP_STATX;
+      request.fd = AT_FDCWD;
+      request.addr = reinterpret_cast<uintptr_t>(paths[i].c_str());
+      request.len = STATX_BASIC_STATS;
+      request.off = reinterpret_cast<uintptr_t>(&buffers[i]);
+    }
+    std::vector<int> results;
+    if (!execute(requests, results)) {
+      return false;
+    }
+    for (size_t i = 0; i < paths.size(); ++i) {
+      if (0 == results[i]) {
+        // As glibc's stat() derives its fields from statx
+        const struct statx & buffer = buffers[i];
+        stamps[i].mtime_sec = static_cast<boost::int64_t>(buffer.stx_mtime.tv_sec);
+        stamps[i].mtime_nsec = static_cast<boost::int64_t>(buffer.stx_mtime.tv_nsec);
+        stamps[i].inode = static_cast<boost::uint64_t>(buffer.stx_ino);
+        stamps[i].device = static_cast<boost::uint64_t>(
+          makedev(buffer.stx_dev_major, buffer.stx_dev_minor));
+        stamps[i].size = static_cast<boost::uint64_t>(buffer.stx_size);
+        handled[i] = true;
+      } else if (-ENOENT == results[i] || -ENOTDIR == results[i]) {
+        handled[i] = true;
+      }
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /// Read whole files of known sizes.
+  /**
+   * \param sizes The size of each file, as of its stamp; a file of another size is not read
+   * \param contents Set to the contents of each file, empty for the files not read
+   * \param handled Set to whether each file was read
+   * \return false if nothing was done, e.g. because io_uring is not available
+   */
+  bool read(
+    const std::vector<std::string> & paths, const std::vector<boost::uint64_t> & sizes,
+    std::vector<std::vector<char> > & contents, std::vector<bool> & handled)
+  {
+    contents.assign(paths.size(), std::vector<char>());
+    handled.assign(paths.size(), false);
+#ifdef PLUGINLIB_HAS_IO_URING
+    if (!isAvailable()) {
+      return false;
+    }
+    std::vector<io_uring_sqe> requests(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      io_uring_sqe & request = requests[i];
+      std::memset(&request, 0, sizeof(request));
+      request.opcode = IORING_OP_OPENAT;
+      request.fd = AT_FDCWD;
+      request.addr = reinterpret_cast<uintptr_t>(paths[i].c_str());
+      request.open_flags = O_RDONLY | O_CLOEXEC;
+    }
+    std::vector<int> fds;
+    if (!execute(requests, fds)) {
+      // Some files may have been opened before the ring failed
+      for (size_t i = 0; i < fds.size(); ++i) {
+        if (fds[i] >= 0) {
+          ::close(fds[i]);
+        }
+      }
+      return false;
+    }
+
+    // One byte more than expected tells a file that grew
+    std::vector<size_t> opened;
+    requests.clear();
+    for (size_t i = 0; i < paths.size(); ++i) {
+      if (fds[i] < 0) {
+        continue;
+      }
+      opened.push_back(i);
+      contents[i].resize(static_cast<size_t>(sizes[i]) + 1);
+      io_uring_sqe request;
+      std::memset(&request, 0, sizeof(request));
+      request.opcode = IORING_OP_READ;
+      request.fd = fds[i];
+      request.addr = reinterpret_cast<uintptr_t>(&contents[i][0]);
+      request.len = static_cast<boost::uint32_t>(contents[i].size());
+      requests.push_back(request);
+    }
+    std::vector<int> lengths;
+    bool read = execute(requests, lengths);
+    for (size_t j = 0; j < opened.size(); ++j) {
+      size_t i = opened[j];
+      if (read && static_cast<boost::uint64_t>(lengths[j]) == sizes[i] && lengths[j] >= 0) {
+        contents[i].resize(static_cast<size_t>(sizes[i]));
+        handled[i] = true;
+      } else {
+        std::vector<char>().swap(contents[i]);
+      }
+    }
+
+    requests.clear();
+    for (size_t j = 0; j < opened.size(); ++j) {
+      io_uring_sqe request;
+      std::memset(&request, 0, sizeof(request));
+      request.opcode = IORING_OP_CLOSE;
+      request.fd = fds[opened[j]];
+      requests.push_back(request);
+    }
+    std::vector<int> closed;
+    if (!execute(requests, closed)) {
+      for (size_t j = 0; j < opened.size(); ++j) {
+        ::close(fds[opened[j]]);
+      }
+    }
+    return read;
+#else
+    (void)sizes;
+    return false;
+#endif
+  }
+
+private:
+  BatchedFileIO(const BatchedFileIO &);
+  BatchedFileIO & operator=(const BatchedFileIO &);
+
+#ifdef PLUGINLIB_HAS_IO_URING
+  void setUp(unsigned int batch_size)
+  {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, batch_size, &params));
+    if (fd < 0) {
+      return;
+    }
+    fd_ = fd;
+    // Kernels before 5.6 lack the operations used
+    if (!(params.features & IORING_FEAT_RW_CUR_POS) ||
+      !(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+      tearDown();
+      return;
+    }
+
+    ring_size_ = std::max<size_t>(
+      params.sq_off.array + params.sq_entries * sizeof(unsigned int),
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_ = ::mmap(NULL, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+        IORING_OFF_SQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void * sqes = ::mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        fd_, IORING_OFF_SQES);
+    if (MAP_FAILED == ring_ || MAP_FAILED == sqes) {
+      if (MAP_FAILED != sqes) {
+        ::munmap(sqes, sqes_size_);
+      }
+      ring_ = MAP_FAILED;
+      tearDown();
+      return;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+    char * ring = static_cast<char *>(ring_);
+    capacity_ = params.sq_entries;
+    sq_tail_ = reinterpret_cast<unsigned int *>(ring + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned int *>(ring + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned int *>(ring + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned int *>(ring + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned int *>(ring + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned int *>(ring + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+  }
+
+  /// Submit the requests a ring full at a time, setting results to their results in order.
+  /**
+   * \return false if the ring failed, in which case it is torn down
+   */
+  bool execute(const std::vector<io_uring_sqe> & requests, std::vector<int> & results)
+  {
+    results.assign(requests.size(), -ECANCELED);
+    if (!isAvailable()) {
+      return false;
+    }
+    for (size_t first = 0; first < requests.size(); ) {
+      unsigned int count =
+        static_cast<unsigned int>(std::min<size_t>(capacity_, requests.size() - first));
+      // Only this thread produces, so the tail needs no atomic read
+      unsigned int tail = *sq_tail_;
+      for (unsigned int i = 0; i < count; ++i, ++tail) {
+        unsigned int index = tail & sq_mask_;
+        sqes_[index] = requests[first + i];
+        sqes_[index].user_data = first + i;
+        sq_array_[index] = index;
+      }
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+      unsigned int completed = 0;
+      unsigned int pending = count;
+      while (completed < count) {
+        long submitted = ::syscall(__NR_io_uring_enter, fd_, pending, count - completed,  // NOLINT
+            IORING_ENTER_GETEVENTS, NULL, 0);
+        if (submitted < 0 && EINTR != errno) {
+          tearDown();
+          return false;
+        }
+        pending -= std::min<unsigned int>(pending, submitted > 0 ? submitted : 0);
+        unsigned int head = *cq_head_;
+        unsigned int cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != cq_tail; ++head, ++completed) {
+          const io_uring_cqe & completion = cqes_[head & cq_mask_];
+          results[static_cast<size_t>(completion.user_data)] = completion.res;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      }
+      first += count;
+    }
+    return true;
+  }
+#endif
+
+  void tearDown()
+  {
+#ifdef PLUGINLIB_HAS_IO_URING
+    if (fd_ < 0) {
+      return;
+    }
+    if (sqes_) {
+      ::munmap(sqes_, sqes_size_);
+      sqes_ = NULL;
+    }
+    if (MAP_FAILED != ring_) {
+      ::munmap(ring_, ring_size_);
+      ring_ = MAP_FAILED;
+    }
+    ::close(fd_);
+    fd_ = -1;
+#endif
+  }
+
+  int fd_;
+#ifdef PLUGINLIB_HAS_IO_URING
+  void * ring_;
+  size_t ring_size_;
+  io_uring_sqe * sqes_;
+  size_t sqes_size_;
+  unsigned int capacity_;
+  unsigned int * sq_tail_;
+  unsigned int sq_mask_;
+  unsigned int * sq_array_;
+  unsigned int * cq_head_;
+  unsigned int * cq_tail_;
+  unsigned int cq_mask_;
+  io_uring_cqe * cqes_;
+#endif
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__BATCHED_FILE_IO_HPP_
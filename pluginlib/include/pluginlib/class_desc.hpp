@@ -67,16 +67,44 @@ public:
     description_(description),
     library_name_(library_name),
     resolved_library_path_("UNRESOLVED"),
-    plugin_manifest_path_(plugin_manifest_path) {}
+    plugin_manifest_path_(plugin_manifest_path),
+    description_offset_(std::string::npos),
+    description_length_(0) {}
+
+  /// Leave the description in the plugin manifest, to be read from there when it is asked for.
+  /**
+   * \param offset The offset of the text of the class's <description> tag in the manifest
+   * \param length The length of the text, which needs no decoding
+   */
+  void deferDescription(size_t offset, size_t length)
+  {
+    description_.clear();
+    description_offset_ = offset;
+    description_length_ = length;
+  }
+
+  /// Return whether the description is left in the plugin manifest instead of description_.
+  bool isDescriptionDeferred() const
+  {
+    return std::string::npos != description_offset_;
+  }
 
   std::string lookup_name_;
   std::string derived_class_;
   std::string base_class_;
   std::string package_;
+  // Empty if the description is deferred.
   std::string description_;
   std::string library_name_;
-  std::string resolved_library_path_;  // This is set by pluginlib::ClassLoader at load time.
+  /// \deprecated Left "UNRESOLVED" by pluginlib::ClassLoader, which resolves library paths per
+  /// loader since descriptions are shared between loaders; use
+  /// ClassLoader::getClassLibraryPath() instead. Only set ahead of time for descriptions read
+  /// from a pluginlib::WorkspaceIndex.
+  std::string resolved_library_path_;
   std::string plugin_manifest_path_;
+  // Where a deferred description is in the plugin manifest, see deferDescription().
+  size_t description_offset_;
+  size_t description_length_;
 };
 
 }  // namespace pluginlib
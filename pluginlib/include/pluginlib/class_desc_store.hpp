@@ -0,0 +1,540 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__CLASS_DESC_STORE_HPP_
+#define PLUGINLIB__CLASS_DESC_STORE_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "boost/cstdint.hpp"
+#include "boost/functional/hash.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/unordered_map.hpp"
+#include "boost/unordered_set.hpp"
+#include "boost/utility/string_view.hpp"
+#include "pluginlib/class_desc.hpp"
+#include "pluginlib/lookup_key.hpp"
+#include "pluginlib/mapped_file.hpp"
+#include "pluginlib/plugin_xml_parser.hpp"
+
+namespace pluginlib
+{
+
+class ClassDescRef;
+
+/// Class descriptions packed into one arena of interned strings.
+/**
+ * A ClassDesc holds eight strings of its own, although most classes share the base class,
+ * package, library and manifest path with their neighbours. A store keeps each distinct string
+ * once, NUL terminated in a single buffer, and each class as eight 32-bit offsets into it. A
+ * catalog thus takes a fraction of the memory of the descriptions it was built from, and a scan
+ * over its classes touches few cache lines.
+ *
+ * Deferred descriptions (see ClassDesc::deferDescription()) are kept as their location in the
+ * plugin manifest, and only read from it when first asked for.
+ *
+ * Stores are filled by a ClassDescStore::Builder and never modified once built, apart from
+ * remembering the deferred descriptions read.
+ */
+class ClassDescStore : private boost::noncopyable
+{
+public:
+  typedef boost::shared_ptr<const ClassDescStore> ConstPtr;
+
+  /// The offsets of the strings of one class description in the arena.
+  struct Entry
+  {
+    boost::uint32_t lookup_name;
+    boost::uint32_t derived_class;
+    boost::uint32_t base_class;
+    boost::uint32_t package;
+    // The text in the arena if description_length is kInlineDescription, otherwise the offset
+    // of a deferred description in the plugin manifest.
+    boost::uint32_t description;
+    boost::uint32_t description_length;
+    boost::uint32_t library_name;
+    boost::uint32_t resolved_library_path;
+    boost::uint32_t plugin_manifest_path;
+  };
+
+  static const boost::uint32_t kInlineDescription = 0xffffffff;
+
+  class Builder;
+
+  /// Return the number of class descriptions.
+  size_t size() const
+  {
+    return entries_.size();
+  }
+
+  const Entry & getEntry(size_t index) const
+  {
+    return entries_[index];
+  }
+
+  /// Return the NUL terminated string at an offset of the arena.
+  const char * getString(boost::uint32_t offset) const
+  {
+    return &strings_[offset];
+  }
+
+  /// Return the description of an entry, reading a deferred one from the manifest once.
+  const char * getDescription(const Entry & entry) const
+  {
+    if (kInlineDescription == entry.description_length) {
+      return getString(entry.description);
+    }
+    boost::mutex::scoped_lock lock(descriptions_mutex_);
+    boost::uint32_t index = static_cast<boost::uint32_t>(&entry - &entries_[0]);
+    boost::unordered_map<boost::uint32_t, std::string>::const_iterator it =
+      read_descriptions_.find(index);
+    if (it == read_descriptions_.end()) {
+      it = read_descriptions_.insert(std::make_pair(index, readDescription(entry))).first;
+    }
+    // Elements of the map do not move when it grows
+    return it->second.c_str();
+  }
+
+  /// Return whether the description of an entry is in memory, not only in the manifest.
+  bool isDescriptionRead(const Entry & entry) const
+  {
+    if (kInlineDescription == entry.description_length) {
+      return true;
+    }
+    boost::mutex::scoped_lock lock(descriptions_mutex_);
+    return read_descriptions_.count(static_cast<boost::uint32_t>(&entry - &entries_[0])) > 0;
+  }
+
+  /// Return the number of bytes the store occupies, not counting deferred descriptions read.
+  size_t getMemoryUsage() const
+  {
+    return sizeof(*this) + entries_.capacity() * sizeof(Entry) + strings_.capacity();
+  }
+
+private:
+  ClassDescStore() {}
+
+  std::string readDescription(const Entry & entry) const
+  {
+    MappedFile file(getString(entry.plugin_manifest_path));
+    if (!file.isOpen()) {
+      return "";
+    }
+    // The text ends where the end tag starts, unless the manifest was edited since it was parsed
+    static const char end_tag[] = "</description";
+    size_t end = static_cast<size_t>(entry.description) + entry.description_length;
+    if (entry.description > 0 && end + sizeof(end_tag) - 1 <= file.size() &&
+      '>' == file.data()[entry.description - 1] &&
+      0 == std::memcmp(file.data() + end, end_tag, sizeof(end_tag) - 1) &&
+      NULL == std::memchr(file.data() + entry.description, '<', entry.description_length))
+    {
+      return std::string(file.data() + entry.description, entry.description_length);
+    }
+    std::vector<PluginXMLClass> declarations;
+    if (PluginXMLParser::parseClasses(file.data(), file.size(), declarations)) {
+      const char * lookup_name = getString(entry.lookup_name);
+      for (size_t i = 0; i < declarations.size(); ++i) {
+        const PluginXMLClass & declaration = declarations[i];
+        if ((declaration.has_lookup_name ? declaration.lookup_name : declaration.type) ==
+          lookup_name && declaration.base_class_type == getString(entry.base_class))
+        {
+          return std::string(declaration.description.data(), declaration.description.size());
+        }
+      }
+    }
+    return "";
+  }
+
+  std::vector<char> strings_;
+  std::vector<Entry> entries_;
+  mutable boost::mutex descriptions_mutex_;
+  // Deferred descriptions read so far, by entry index.
+  mutable boost::unordered_map<boost::uint32_t, std::string> read_descriptions_;
+};
+
+/// A class description in a ClassDescStore, valid for as long as the store.
+class ClassDescRef
+{
+public:
+  ClassDescRef()
+  : store_(NULL), entry_(NULL) {}
+
+  ClassDescRef(const ClassDescStore & store, const ClassDescStore::Entry & entry)
+  : store_(&store), entry_(&entry) {}
+
+  /// Return whether the reference refers to a description at all.
+  bool isValid() const
+  {
+    return NULL != entry_;
+  }
+
+  const char * getLookupName() const
+  {
+    return store_->getString(entry_->lookup_name);
+  }
+
+  const char * getDerivedClass() const
+  {
+    return store_->getString(entry_->derived_class);
+  }
+
+  const char * getBaseClass() const
+  {
+    return store_->getString(entry_->base_class);
+  }
+
+  const char * getPackage() const
+  {
+    return store_->getString(entry_->package);
+  }
+
+  /// Return the description, which a deferred one is read for when first asked for.
+  const char * getDescription() const
+  {
+    return store_->getDescription(*entry_);
+  }
+
+  /// Return whether getDescription() can answer without reading the plugin manifest.
+  bool isDescriptionRead() const
+  {
+    return store_->isDescriptionRead(*entry_);
+  }
+
+  const char * getLibraryName() const
+  {
+    return store_->getString(entry_->library_name);
+  }
+
+  const char * getResolvedLibraryPath() const
+  {
+    return store_->getString(entry_->resolved_library_path);
+  }
+
+  const char * getPluginManifestPath() const
+  {
+    return store_->getString(entry_->plugin_manifest_path);
+  }
+
+  /// Copy the description out of the store, leaving a deferred description deferred.
+  ClassDesc toClassDesc() const
+  {
+    bool deferred = ClassDescStore::kInlineDescription != entry_->description_length;
+    ClassDesc desc(getLookupName(), getDerivedClass(), getBaseClass(), getPackage(),
+      deferred ? "" : getDescription(), getLibraryName(), getPluginManifestPath());
+    desc.resolved_library_path_ = getResolvedLibraryPath();
+    if (deferred) {
+      desc.deferDescription(entry_->description, entry_->description_length);
+    }
+    return desc;
+  }
+
+  const ClassDescStore::Entry & getEntry() const
+  {
+    return *entry_;
+  }
+
+private:
+  const ClassDescStore * store_;
+  const ClassDescStore::Entry * entry_;
+};
+
+/// Fills a ClassDescStore, storing every distinct string once.
+class ClassDescStore::Builder : private boost::noncopyable
+{
+public:
+  Builder()
+  : store_(new ClassDescStore()),
+    interned_(0, StringHash(&store_->strings_), StringEqual(&store_->strings_)) {}
+
+  /// Append a class description, returning its index in the store.
+  boost::uint32_t add(const ClassDesc & desc)
+  {
+    Entry entry;
+    entry.lookup_name = intern(desc.lookup_name_.c_str());
+    entry.derived_class = intern(desc.derived_class_.c_str());
+    entry.base_class = intern(desc.base_class_.c_str());
+    entry.package = intern(desc.package_.c_str());
+    if (desc.isDescriptionDeferred()) {
+      entry.description = static_cast<boost::uint32_t>(desc.description_offset_);
+      entry.description_length = static_cast<boost::uint32_t>(desc.description_length_);
+    } else {
+      entry.description = intern(desc.description_.c_str());
+      entry.description_length = kInlineDescription;
+    }
+    entry.library_name = intern(desc.library_name_.c_str());
+    entry.resolved_library_path = intern(desc.resolved_library_path_.c_str());
+    entry.plugin_manifest_path = intern(desc.plugin_manifest_path_.c_str());
+    return append(entry);
+  }
+
+  /// Append a copy of a description from another store, returning its index in this one.
+  /**
+   * A deferred description the other store read is copied, so that it is not read again from
+   * a manifest that may have been edited since; one not read yet stays deferred.
+   */
+  boost::uint32_t add(const ClassDescRef & desc)
+  {
+    Entry entry;
+    entry.lookup_name = intern(desc.getLookupName());
+    entry.derived_class = intern(desc.getDerivedClass());
+    entry.base_class = intern(desc.getBaseClass());
+    entry.package = intern(desc.getPackage());
+    if (desc.isDescriptionRead()) {
+      entry.description = intern(desc.getDescription());
+      entry.description_length = kInlineDescription;
+    } else {
+      entry.description = desc.getEntry().description;
+      entry.description_length = desc.getEntry().description_length;
+    }
+    entry.library_name = intern(desc.getLibraryName());
+    entry.resolved_library_path = intern(desc.getResolvedLibraryPath());
+    entry.plugin_manifest_path = intern(desc.getPluginManifestPath());
+    return append(entry);
+  }
+
+  /// Return the filled store; the builder must not be used any more.
+  ConstPtr build()
+  {
+    interned_.clear();
+    std::vector<char>(store_->strings_).swap(store_->strings_);
+    std::vector<Entry>(store_->entries_).swap(store_->entries_);
+    return store_;
+  }
+
+private:
+  /// Hashes the string at an offset of the arena.
+  struct StringHash
+  {
+    explicit StringHash(const std::vector<char> * strings)
+    : strings(strings) {}
+
+    size_t operator()(boost::uint32_t offset) const
+    {
+      const char * value = &(*strings)[offset];
+      return boost::hash_range(value, value + std::strlen(value));
+    }
+
+    const std::vector<char> * strings;
+  };
+
+  /// Compares the strings at two offsets of the arena.
+  struct StringEqual
+  {
+    explicit StringEqual(const std::vector<char> * strings)
+    : strings(strings) {}
+
+    bool operator()(boost::uint32_t lhs, boost::uint32_t rhs) const
+    {
+      return 0 == std::strcmp(&(*strings)[lhs], &(*strings)[rhs]);
+    }
+
+    const std::vector<char> * strings;
+  };
+
+  boost::uint32_t intern(const char * value)
+  {
+    // Append the string and take it back again if the arena already holds it
+    std::vector<char> & strings = store_->strings_;
+    size_t offset = strings.size();
+    size_t size = std::strlen(value) + 1;
+    if (offset + size > 0xffffffffULL) {
+      throw std::length_error("The strings of a ClassDescStore exceed 4 GiB.");
+    }
+    strings.insert(strings.end(), value, value + size);
+    std::pair<boost::unordered_set<boost::uint32_t, StringHash, StringEqual>::iterator, bool>
+    inserted = interned_.insert(static_cast<boost::uint32_t>(offset));
+    if (!inserted.second) {
+      strings.resize(offset);
+    }
+    return *inserted.first;
+  }
+
+  boost::uint32_t append(const Entry & entry)
+  {
+    store_->entries_.push_back(entry);
+    return static_cast<boost::uint32_t>(store_->entries_.size() - 1);
+  }
+
+  boost::shared_ptr<ClassDescStore> store_;
+  boost::unordered_set<boost::uint32_t, StringHash, StringEqual> interned_;
+};
+
+/// Classes by lookup name, viewed as entries of a ClassDescStore sorted by their lookup name.
+/**
+ * Each class takes four bytes beyond its entry, and a lookup is a binary search over them.
+ * Tables of several base classes can share one store.
+ */
+class ClassDescTable
+{
+public:
+  typedef boost::shared_ptr<const ClassDescTable> ConstPtr;
+
+  ClassDescTable() {}
+
+  /**
+   * \param store The store holding the classes, which the table keeps alive
+   * \param entries The indices of the classes in the store, in order of precedence; of several
+   * entries with the same lookup name only the first is kept
+   */
+  ClassDescTable(
+    const ClassDescStore::ConstPtr & store, const std::vector<boost::uint32_t> & entries)
+  : store_(store), entries_(entries)
+  {
+    sortEntries();
+  }
+
+  /// Copy descriptions into a store of the table's own; the first of a lookup name is kept.
+  explicit ClassDescTable(const std::vector<ClassDescRef> & classes)
+  {
+    ClassDescStore::Builder builder;
+    for (size_t i = 0; i < classes.size(); ++i) {
+      entries_.push_back(builder.add(classes[i]));
+    }
+    store_ = builder.build();
+    sortEntries();
+  }
+
+  /// Copy descriptions keyed by lookup name into a store of the table's own.
+  explicit ClassDescTable(const std::map<std::string, ClassDesc> & classes)
+  {
+    ClassDescStore::Builder builder;
+    for (std::map<std::string, ClassDesc>::const_iterator it = classes.begin();
+      it != classes.end(); ++it)
+    {
+      entries_.push_back(builder.add(it->second));
+    }
+    store_ = builder.build();
+    sortEntries();
+  }
+
+  size_t size() const
+  {
+    return entries_.size();
+  }
+
+  bool empty() const
+  {
+    return entries_.empty();
+  }
+
+  /// Return the class at a position in lookup name order.
+  ClassDescRef operator[](size_t index) const
+  {
+    return ClassDescRef(*store_, store_->getEntry(entries_[index]));
+  }
+
+  /// Return the class with a lookup name, or an invalid reference if there is none.
+  ClassDescRef find(boost::string_view lookup_name) const
+  {
+    if (entries_.empty()) {
+      return ClassDescRef();
+    }
+    std::vector<boost::uint32_t>::const_iterator it = std::lower_bound(
+      entries_.begin(), entries_.end(), lookup_name, LookupNameLess(store_.get()));
+    if (it == entries_.end() ||
+      lookup_name != store_->getString(store_->getEntry(*it).lookup_name))
+    {
+      return ClassDescRef();
+    }
+    return ClassDescRef(*store_, store_->getEntry(*it));
+  }
+
+  /// Like find(boost::string_view), the table being ordered by name rather than hash.
+  ClassDescRef find(const LookupKey & key) const
+  {
+    return find(key.getName());
+  }
+
+  /// Return the store holding the classes, which may be NULL for an empty table.
+  const ClassDescStore::ConstPtr & getStore() const
+  {
+    return store_;
+  }
+
+private:
+  /// Orders entry indices, or an entry index and a name, by lookup name.
+  struct LookupNameLess
+  {
+    explicit LookupNameLess(const ClassDescStore * store)
+    : store(store) {}
+
+    const char * getName(boost::uint32_t entry) const
+    {
+      return store->getString(store->getEntry(entry).lookup_name);
+    }
+
+    bool operator()(boost::uint32_t lhs, boost::uint32_t rhs) const
+    {
+      return std::strcmp(getName(lhs), getName(rhs)) < 0;
+    }
+
+    bool operator()(boost::uint32_t lhs, boost::string_view rhs) const
+    {
+      return boost::string_view(getName(lhs)) < rhs;
+    }
+
+    const ClassDescStore * store;
+  };
+
+  /// Interned names are equal exactly if their offsets are.
+  struct SameLookupName
+  {
+    explicit SameLookupName(const ClassDescStore * store)
+    : store(store) {}
+
+    bool operator()(boost::uint32_t lhs, boost::uint32_t rhs) const
+    {
+      return store->getEntry(lhs).lookup_name == store->getEntry(rhs).lookup_name;
+    }
+
+    const ClassDescStore * store;
+  };
+
+  void sortEntries()
+  {
+    std::stable_sort(entries_.begin(), entries_.end(), LookupNameLess(store_.get()));
+    entries_.erase(std::unique(entries_.begin(), entries_.end(), SameLookupName(store_.get())),
+      entries_.end());
+    std::vector<boost::uint32_t>(entries_).swap(entries_);
+  }
+
+  ClassDescStore::ConstPtr store_;
+  std::vector<boost::uint32_t> entries_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__CLASS_DESC_STORE_HPP_
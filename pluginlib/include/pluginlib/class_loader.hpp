@@ -31,14 +31,36 @@
 #define PLUGINLIB__CLASS_LOADER_HPP_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "boost/algorithm/string.hpp"
+#include "boost/function.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/future.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+#include "boost/utility/string_view.hpp"
 #include "class_loader/multi_library_class_loader.hpp"
+#include "pluginlib/batched_file_io.hpp"
 #include "pluginlib/class_desc.hpp"
+#include "pluginlib/class_desc_store.hpp"
 #include "pluginlib/class_loader_base.hpp"
+#include "pluginlib/compiled_manifest.hpp"
+#include "pluginlib/discovery_options.hpp"
+#include "pluginlib/discovery_registry.hpp"
 #include "pluginlib/exceptions.hpp"
+#include "pluginlib/executor.hpp"
+#include "pluginlib/frozen_class_table.hpp"
+#include "pluginlib/library_prefetcher.hpp"
+#include "pluginlib/lookup_key.hpp"
+#include "pluginlib/plugin_catalog.hpp"
+#include "pluginlib/plugin_handle.hpp"
+#include "pluginlib/plugin_manifest.hpp"
+#include "pluginlib/plugin_watcher.hpp"
+#include "pluginlib/workspace_index.hpp"
 #include "ros/console.h"
 #include "ros/package.h"
 #include "tinyxml2.h"  // NOLINT
@@ -62,6 +84,9 @@ class ClassLoader : public ClassLoaderBase
 {
 public:
   typedef typename std::map<std::string, ClassDesc>::iterator ClassMapIterator;
+  typedef typename std::map<std::string, ClassDesc>::const_iterator ClassMapConstIterator;
+  typedef boost::function<void (PluginEvent event, const std::string & lookup_name)>
+    PluginEventCallback;
 
 public:
   /**
@@ -69,16 +94,26 @@ public:
    * \param base_class The type of the base class for classes to be loaded
    * \param attrib_name The attribute to search for in manifext.xml files, defaults to "plugin"
    * \param plugin_xml_paths The list of paths of plugin.xml files, defaults to be crawled via
-   *   ros::package::getPlugins()
-   * \throws pluginlib::ClassLoaderException if package manifest cannot be found
+   *   the discovery backend
+   * \param options How to discover the plugins, e.g. which backend crawls for plugin.xml files
+   * \throws pluginlib::ClassLoaderException if package manifest cannot be found; with deferred
+   *   discovery, the methods needing the discovery results throw it instead
    */
   ClassLoader(
     std::string package, std::string base_class,
     std::string attrib_name = std::string("plugin"),
-    std::vector<std::string> plugin_xml_paths = std::vector<std::string>());
+    std::vector<std::string> plugin_xml_paths = std::vector<std::string>(),
+    const DiscoveryOptions & options = DiscoveryOptions());
 
   ~ClassLoader();
 
+  /// Return a future that becomes ready once the available classes were discovered.
+  /**
+   * Only useful with deferred discovery, otherwise discovery completed in the constructor.
+   * Getting the future's value throws pluginlib::ClassLoaderException if discovery failed.
+   */
+  boost::shared_future<void> ready() const;
+
   /// Create an instance of a desired class, optionally loading the associated library too.
   /**
    * \param lookup_name The name of the class to load
@@ -144,6 +179,36 @@ public:
    */
   T * createUnmanagedInstance(const std::string & lookup_name);
 
+  /// Like createInstance(const std::string &), with a key hashed ahead of time.
+  /**
+   * Once the loader is frozen, the class is found by a single probe of the frozen table for
+   * the key's hash, and the name is only compared to verify the match.
+   * \param key The lookup name and its hash, e.g. "pluginlib/foo"_plugin, see LookupKey
+   */
+  boost::shared_ptr<T> createInstance(const LookupKey & key);
+
+#if __cplusplus >= 201103L
+  /// Like createUniqueInstance(const std::string &), with a key hashed ahead of time.
+  UniquePtr<T> createUniqueInstance(const LookupKey & key);
+#endif
+
+  /// Like createUnmanagedInstance(const std::string &), with a key hashed ahead of time.
+  T * createUnmanagedInstance(const LookupKey & key);
+
+  /// Resolve a class once, to create instances of it through the returned handle.
+  /**
+   * Loads the library containing the class if needed, and keeps it loaded as long as the
+   * handle or a copy of it exists. Creating instances through the handle skips the lookups
+   * createInstance() does each time, see PluginHandle.
+   *
+   * \param lookup_name The name of the class to resolve
+   * \throws pluginlib::LibraryLoadException when the library associated with
+   *   the class cannot be loaded
+   * \throws pluginlib::CreateClassException when the library does not register the class
+   * \return A valid handle for the class
+   */
+  PluginHandle<T> getPluginHandle(const std::string & lookup_name);
+
   /// Return a list of all available plugin manifest paths for this ClassLoader's base class type.
   /**
    * \return A vector of strings corresponding to the paths of all available plugin manifests
@@ -156,6 +221,14 @@ public:
    */
   std::vector<std::string> getDeclaredClasses();
 
+  /// Return the catalog the available classes are drawn from.
+  /**
+   * The catalog holds the classes of every base class declared by the same plugin manifests,
+   * shared with the other loaders for this package and attribute.
+   * \return The catalog of the last discovery or refresh
+   */
+  virtual PluginCatalog::ConstPtr getPluginCatalog();
+
   /// Strip the package name off of a lookup name.
   /**
    * \param lookup_name The name of the plugin
@@ -224,6 +297,40 @@ public:
    */
   virtual bool isClassAvailable(const std::string & lookup_name);
 
+  /// Check if a plugin is available without copying a literal lookup name into a std::string.
+  bool isClassAvailable(const char * lookup_name);
+
+  /// Check if a plugin is available, looking the name up as the given view.
+  bool isClassAvailable(boost::string_view lookup_name);
+
+  /// Check if a plugin is available, with a key hashed ahead of time.
+  bool isClassAvailable(const LookupKey & key);
+
+  /// Like getClassType(), but without allocating.
+  /**
+   * This and the other ...View() accessors take the lookup name as a view, which a std::string
+   * or a string literal converts to without being copied, and return a view into the loader's
+   * catalog. The views are NUL terminated and stay valid until a refresh finds a plugin
+   * manifest changed, or the loader is destroyed.
+   * \return The type of the derived class, or an empty view if there is no such class
+   */
+  boost::string_view getClassTypeView(boost::string_view lookup_name) const;
+
+  /// Like getClassTypeView(boost::string_view), with a key hashed ahead of time.
+  boost::string_view getClassTypeView(const LookupKey & key) const;
+
+  /// Like getClassDescription(), but without allocating once the description was read.
+  boost::string_view getClassDescriptionView(boost::string_view lookup_name) const;
+
+  /// Like getClassPackage(), but without allocating.
+  boost::string_view getClassPackageView(boost::string_view lookup_name) const;
+
+  /// Like getPluginManifestPath(), but without allocating.
+  boost::string_view getPluginManifestPathView(boost::string_view lookup_name) const;
+
+  /// Like getName(), returning the part of the lookup name after the package name.
+  static boost::string_view getNameView(boost::string_view lookup_name);
+
   /// Attempt to load the library containing a class with a given name.
   /**
    * The counter for the library uses (refcount) is also incremented.
@@ -234,42 +341,246 @@ public:
    */
   virtual void loadLibraryForClass(const std::string & lookup_name);
 
+  /// Load the library containing a class on the loader's own thread.
+  /**
+   * Like loadLibraryForClass(), but the library is loaded, and its static initializers run,
+   * while the caller carries on. A load of the same library already in flight is joined
+   * instead of queueing another. Waits for deferred discovery to complete, to find the
+   * library.
+   *
+   * \param lookup_name The lookup name of the class to load
+   * \return A future getting which throws pluginlib::LibraryLoadException if the library
+   *   for the class cannot be loaded
+   */
+  boost::shared_future<void> loadLibraryForClassAsync(const std::string & lookup_name);
+
+  /// Like loadLibraryForClassAsync(), but loading on the given executor.
+  /**
+   * The loader waits for the tasks it posted to run before it is destroyed.
+   */
+  boost::shared_future<void> loadLibraryForClassAsync(
+    const std::string & lookup_name, const Executor::Ptr & executor);
+
+  /// Create an instance of a desired class on the loader's own thread.
+  /**
+   * Like createInstance(), including loading the library if needed, while the caller carries
+   * on. Loads of the library already in flight are waited for rather than repeated.
+   *
+   * \param lookup_name The name of the class to load
+   * \return A future getting which throws like createInstance()
+   */
+  boost::shared_future<boost::shared_ptr<T> > createInstanceAsync(
+    const std::string & lookup_name);
+
+  /// Like createInstanceAsync(), but creating the instance on the given executor.
+  boost::shared_future<boost::shared_ptr<T> > createInstanceAsync(
+    const std::string & lookup_name, const Executor::Ptr & executor);
+
+  /// Warm the page cache for the libraries of the available classes, on the loader's own thread.
+  /**
+   * Asks the kernel to read the libraries, and the libraries they need, in the background, so
+   * that loading them later faults in fewer pages from storage, see LibraryPrefetcher. Queued
+   * ahead of the asynchronous loads asked for later.
+   *
+   * \return A future that becomes ready once the kernel was asked to read every library;
+   *   getting it throws pluginlib::ClassLoaderException if discovery failed
+   */
+  boost::shared_future<void> prefetchLibraries();
+
+  /// Like prefetchLibraries(), but on the given executor.
+  boost::shared_future<void> prefetchLibraries(const Executor::Ptr & executor);
+
   /// Refresh the list of all available classes for this ClassLoader's base class type.
   /**
+   * Equivalent to refreshDeclaredClassesIncremental(), discarding its result.
+   *
    * \throws pluginlib::LibraryLoadException if package manifest cannot be found
    */
   virtual void refreshDeclaredClasses();
 
+  /// Refresh the available classes, re-parsing only the plugin manifests that changed.
+  /**
+   * The plugin manifests are crawled again, but only the ones that were added or whose
+   * modification time, inode or size changed since they were last parsed are read. The
+   * resulting classes are compared with the current ones and only the differences applied.
+   * Classes whose library this loader currently has loaded keep their description until the
+   * library is unloaded, including the text of the <description> tag as it was when the
+   * library was loaded. The library paths resolved by any loader, see LibraryPathCache, are
+   * resolved again when next needed.
+   *
+   * \throws pluginlib::LibraryLoadException if package manifest cannot be found
+   * \throws pluginlib::ClassLoaderException if the loader is frozen
+   * \return The lookup names of the classes that were added, removed or changed
+   */
+  std::set<std::string> refreshDeclaredClassesIncremental();
+
+  /// Fix the available classes for the lifetime of the loader, to make looking them up faster.
+  /**
+   * Indexes the classes in a minimal perfect hash table, after which finding a class by its
+   * lookup name takes a single string comparison. Watching stops, and any later refresh
+   * throws. Freezing a frozen loader has no effect.
+   */
+  void freeze();
+
+  /// Return whether freeze() was called.
+  bool isFrozen() const;
+
+  /// Keep the available classes current as plugins are installed, changed or removed.
+  /**
+   * Starts a background thread that watches, with inotify, the directories of the plugin
+   * manifests, of the packages exporting them and the catkin library directories. Edited
+   * manifests are re-parsed without crawling, package changes trigger a crawl, and rebuilt
+   * libraries are reported as changed plugins. Nothing is polled in between.
+   *
+   * \return false if watching is not supported on this platform or the loader is frozen
+   */
+  bool startWatching();
+
+  /// Stop the watcher started by startWatching(), if any.
+  void stopWatching();
+
+  /// Return whether startWatching() is in effect.
+  bool isWatching() const;
+
+  /// Register a function to be told about plugins that were added, removed or changed.
+  /**
+   * Callbacks are only invoked for changes detected while watching and run on the watcher's
+   * thread, after the available classes were updated.
+   */
+  void addPluginEventCallback(const PluginEventCallback & callback);
+
   /// Decrement the counter for the library containing a class with a given name.
   /**
-   * Also try to unload the library, If the counter reaches zero.
+   * Also try to unload the library, If the counter reaches zero. Libraries which a
+   * PluginHandle keeps loaded are unloaded once the last such handle is released instead.
    *
    * \param lookup_name The lookup name of the class to unload
    * \throws pluginlib::LibraryUnloadException if the library for the
    *   class cannot be unloaded
-   * \return The number of pending unloads until the library is removed from memory
+   * \return The number of pending unloads until the library is removed from memory, or the
+   *   number of plugin handles it waits for
    */
   virtual int unloadLibraryForClass(const std::string & lookup_name);
 
 private:
+  /// Crawl for and parse the plugin.xml files, or take the results from the DiscoveryRegistry.
+  void discover();
+
+  /// Run discover() and report its outcome through promise.
+  void discoverInBackground(boost::shared_ptr<boost::promise<void> > promise);
+
+  /// Block until discovery completed, throwing what it failed with.
+  void waitForDiscovery() const;
+
   /// Return the paths to plugin.xml files.
   /**
+   * \param backend Whether to ask rospack or the built-in PackageCrawler
    * \throws pluginlib::LibraryLoadException if package manifest cannot be found
    * \return A vector of paths
    */
   std::vector<std::string> getPluginXmlPaths(
     const std::string & package,
     const std::string & attrib_name,
-    bool force_recrawl = false);
+    bool force_recrawl = false,
+    DiscoveryBackend backend = DISCOVERY_BACKEND_ROSPACK);
+
+  /// Return the directory of a package, or an empty string if it cannot be found.
+  static std::string getPackagePath(const std::string & package, DiscoveryBackend backend);
 
-  /// Return the available classes.
+  /// Return the classes of all base classes each of the given plugin.xml files declares.
   /**
    * \param plugin_xml_paths The vector of paths of plugin.xml files
-   * \throws pluginlib::LibraryLoadException if package manifest cannot be found
-   * \return A map of class names and the corresponding descriptions
+   * \param previous Manifests parsed before; the ones that did not change since are reused
+   * \throws pluginlib::ClassLoaderException if a class declaration is incomplete
+   * \return One entry per element of plugin_xml_paths, in the same order
+   */
+  std::vector<PluginManifest> determineAvailableManifests(
+    const std::vector<std::string> & plugin_xml_paths,
+    const std::vector<PluginManifest> & previous = std::vector<PluginManifest>());
+
+  /// The lookup names of the classes a refresh added, removed or changed.
+  struct ClassChanges
+  {
+    std::set<std::string> added;
+    std::set<std::string> removed;
+    std::set<std::string> changed;
+  };
+
+  /// Update the available classes from the plugin manifests that changed.
+  /**
+   * \param recrawl Whether to ask the crawler for the current list of plugin manifests
+   * \param changes Filled with the lookup names whose availability or description changed
+   */
+  void refreshClasses(bool recrawl, ClassChanges & changes);
+
+  /// Return the current map of available classes, safe to use while it is refreshed.
+  DiscoveryRegistry::ClassMapPtr getClassesAvailable() const;
+
+  /// Return the description of an available class, invalid if there is none by that name.
+  /**
+   * Looks the class up in the frozen table if there is one.
+   * \param key The lookup name, as a boost::string_view or a LookupKey
+   * \param classes Set to the table holding the description, which stays valid for as long as
+   * the table is held, whatever refreshes happen meanwhile
+   */
+  template<class Key>
+  ClassDescRef findClass(const Key & key, DiscoveryRegistry::ClassMapPtr & classes) const;
+
+  /// Return the type of a class to create an instance of, loading its library if asked to.
+  /**
+   * \throws pluginlib::LibraryLoadException if the class is unknown or its library cannot be
+   * loaded
+   */
+  std::string getClassTypeToCreate(const std::string & lookup_name, bool auto_load);
+
+  /// Like getClassTypeToCreate(const std::string &, bool), with a key hashed ahead of time.
+  std::string getClassTypeToCreate(const LookupKey & key, bool auto_load);
+
+  /// Return the path of the library of a class, or an empty string if it cannot be found.
+  std::string getClassLibraryPath(const ClassDescRef & desc);
+
+  /// Return the directories startWatching() monitors.
+  std::set<std::string> getWatchedDirectories();
+
+  /// Refresh after the watcher saw the given paths change, and notify the callbacks.
+  void onWatchedPathsChanged(const std::set<std::string> & changed_paths);
+
+  /// Add the classes from a table generated at build time.
+  void addCompiledClasses(const CompiledManifest & compiled, PluginManifest & manifest);
+
+  /// Add the classes from the workspace index.
+  void addIndexedClasses(const WorkspaceIndex::Manifest & indexed, PluginManifest & manifest);
+
+  /// Return whether two descriptions of a class differ in anything read from the manifest.
+  static bool isClassDescChanged(const ClassDescRef & old_desc, const ClassDescRef & new_desc);
+
+  /// Outcome of parsing a single plugin manifest in determineAvailableManifests().
+  struct ManifestParseResult
+  {
+    ManifestParseResult()
+    : fatal(false), prefetched(false) {}
+
+    // Whether the error must abort discovery rather than just skip the manifest
+    bool fatal;
+    std::string error;
+    // Whether contents holds the manifest, as read ahead by a BatchedFileIO
+    bool prefetched;
+    std::vector<char> contents;
+  };
+
+  /// Read the manifests ahead of parsing them, into the contents of their results.
+  void prefetchManifests(
+    BatchedFileIO & batched_io, const std::vector<PluginManifest *> & manifests,
+    std::vector<ManifestParseResult> & results);
+
+  /// Parse *manifests[index], recording instead of throwing any error in results[index].
+  /**
+   * Called concurrently for different indices from determineAvailableManifests().
    */
-  std::map<std::string, ClassDesc> determineAvailableClasses(
-    const std::vector<std::string> & plugin_xml_paths);
+  void parseManifest(
+    std::vector<PluginManifest *> * manifests,
+    std::vector<ManifestParseResult> * results,
+    size_t index);
 
   /// Open a package.xml file and extract the package name (i.e. contents of <name> tag).
   /**
@@ -312,12 +623,63 @@ private:
 
   /// Parse a plugin XML file.
   /**
-   * Also insert the appropriate ClassDesc entries into the passes
-   * classes_available map.
+   * Also insert the appropriate ClassDesc entries into the passes classes_available map, for
+   * every base class. Uses the streaming PluginXMLParser and falls back to tinyxml2 for
+   * files it cannot handle.
    */
   void processSingleXMLPluginFile(
-    const std::string & xml_file, std::map<std::string,
-    ClassDesc> & class_available);
+    const std::string & xml_file,
+    std::map<std::string, PluginManifest::ClassMap> & classes_available);
+
+  /// Parse a plugin XML file already read into memory.
+  /**
+   * \param data The contents of xml_file, which deferred descriptions are located relative to
+   */
+  void processSingleXMLPluginFile(
+    const std::string & xml_file, const char * data, size_t size,
+    std::map<std::string, PluginManifest::ClassMap> & classes_available);
+
+  /// Parse a plugin XML file with tinyxml2, the reference for processSingleXMLPluginFile().
+  void processSingleXMLPluginFileWithTinyXML(
+    const std::string & xml_file,
+    std::map<std::string, PluginManifest::ClassMap> & classes_available);
+
+  /// Return the path of the library to load a class from.
+  /**
+   * \throws pluginlib::LibraryLoadException if the class is unknown or its library not found
+   */
+  std::string getLibraryPathToLoad(const std::string & lookup_name);
+
+  /// Load a library and record that the given classes were loaded from it.
+  /**
+   * \throws pluginlib::LibraryLoadException if the library cannot be loaded
+   */
+  void loadClassLibraryInternal(
+    const std::string & library_path, const std::vector<std::string> & lookup_names);
+
+  /// Return the executor for the asynchronous methods, started on first use.
+  Executor::Ptr getExecutor();
+
+  /// Load a library for loadLibraryForClassAsync(), on the executor.
+  void runLibraryLoad(
+    const std::string & library_path, boost::shared_ptr<boost::promise<void> > promise);
+
+  /// Prefetch the libraries for prefetchLibraries(), on the executor.
+  void runPrefetchLibraries(boost::shared_ptr<boost::promise<void> > promise);
+
+  /// Forget a library load in flight, returning the classes it was asked for.
+  std::vector<std::string> endLibraryLoad(const std::string & library_path);
+
+  /// Create an instance for createInstanceAsync(), on the executor.
+  void runCreateInstance(
+    const std::string & lookup_name,
+    boost::shared_ptr<boost::promise<boost::shared_ptr<T> > > promise);
+
+  /// Count a task posted to an executor, which the destructor waits for.
+  void startAsyncTask();
+
+  /// Count a task posted to an executor as done, its last access to the loader.
+  void finishAsyncTask();
 
   /// Strip all but the filename from an explicit file path.
   /**
@@ -334,14 +696,58 @@ private:
    */
   int unloadClassLibraryInternal(const std::string & library_path);
 
+  /// Delete the state of the last copy of a PluginHandle, carrying out a deferred unload.
+  void releasePluginHandle(const typename PluginHandle<T>::State * state);
+
 private:
+  // Guards plugin_xml_paths_, classes_available_, catalog_, frozen_classes_, watcher_ and the
+  // callbacks.
+  mutable boost::mutex classes_mutex_;
+  // Guards resolved_library_paths_ and loading or unloading libraries.
+  boost::mutex library_mutex_;
+  // Serializes refreshes.
+  boost::mutex refresh_mutex_;
   std::vector<std::string> plugin_xml_paths_;
-  // Map from library to class's descriptions described in XML.
-  std::map<std::string, ClassDesc> classes_available_;
+  // Discovery results shared with other loaders, unset if plugin_xml_paths were given explicitly.
+  DiscoveryRegistry::EntryPtr discovery_;
+  // Map from lookup name to class's descriptions described in XML, shared and never modified.
+  // Replaced only by a refresh that finds a plugin manifest changed.
+  DiscoveryRegistry::ClassMapPtr classes_available_;
+  // The catalog classes_available_ was drawn from, kept to refresh incrementally.
+  PluginCatalog::ConstPtr catalog_;
+  // Index of classes_available_ once the loader is frozen, otherwise NULL.
+  FrozenClassTable::ConstPtr frozen_classes_;
+  // Map from lookup name to the library path this loader loaded the class from.
+  std::map<std::string, std::string> resolved_library_paths_;
+  // Plugin handles keeping libraries loaded, and the unloads waiting for them.
+  LibraryPins::Ptr library_pins_;
+  boost::shared_ptr<PluginWatcher> watcher_;
+  std::vector<PluginEventCallback> plugin_event_callbacks_;
   std::string package_;
   std::string base_class_;
   std::string attrib_name_;
+  DiscoveryOptions options_;
+  // Completes when discover() returned, or holds what it threw.
+  boost::shared_future<void> ready_;
+  boost::shared_ptr<boost::thread> discovery_thread_;
   class_loader::MultiLibraryClassLoader lowlevel_class_loader_;  // The underlying classloader
+
+  /// A library load posted by loadLibraryForClassAsync() and not completed yet.
+  struct LibraryLoad
+  {
+    boost::shared_future<void> done;
+    // The classes the load was asked for, recorded as loaded when it completes
+    std::vector<std::string> lookup_names;
+  };
+
+  // Guards library_loads_, async_task_count_ and executor_.
+  boost::mutex async_mutex_;
+  boost::condition_variable async_condition_;
+  // Map from library path to the load in flight, for concurrent requests to join.
+  std::map<std::string, LibraryLoad> library_loads_;
+  size_t async_task_count_;
+  // Declared last, so its threads are joined before anything they may use is destroyed.
+  Executor::Ptr executor_;
 };
 
 }  // namespace pluginlib
@@ -33,6 +33,8 @@
 #include <string>
 #include <vector>
 
+#include "pluginlib/plugin_catalog.hpp"
+
 namespace pluginlib
 {
 /// Pure virtual base class of pluginlib::ClassLoader which is not templated.
@@ -150,6 +152,18 @@ public:
    * \return The path to the associated library
    */
   virtual std::string getClassLibraryPath(const std::string & lookup_name) = 0;
+
+  /// Return the catalog the available classes are drawn from.
+  /**
+   * Non-templated code can take the classes of any other base class declared by the same
+   * plugin manifests from it, without parsing them again. Loaders not overriding this, such as
+   * subclasses written before it was added, return an empty catalog.
+   * \return The catalog holding the classes of every declared base class
+   */
+  virtual PluginCatalog::ConstPtr getPluginCatalog()
+  {
+    return PluginCatalog::ConstPtr(new PluginCatalog());
+  }
 };
 }  // namespace pluginlib
 
@@ -37,10 +37,12 @@
 #ifndef PLUGINLIB__CLASS_LOADER_IMP_HPP_
 #define PLUGINLIB__CLASS_LOADER_IMP_HPP_
 
+#include <algorithm>
 #include <cstdlib>
-#include <list>
+#include <cstring>
 #include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -51,11 +53,26 @@
 #include "boost/bind.hpp"
 #include "boost/filesystem.hpp"
 #include "boost/foreach.hpp"
+#include "boost/scoped_ptr.hpp"
+#include "boost/thread/future.hpp"
+#include "boost/thread/thread.hpp"
 #include "class_loader/class_loader.hpp"
 
 #include "ros/package.h"
 
 #include "./class_loader.hpp"
+#include "./compiled_manifest.hpp"
+#include "./library_path_cache.hpp"
+#include "./library_path_resolver.hpp"
+#include "./package_crawler.hpp"
+#include "./mapped_file.hpp"
+#include "./package_directory_cache.hpp"
+#include "./parallel_for.hpp"
+#include "./plugin_index_cache.hpp"
+#include "./plugin_watcher.hpp"
+#include "./plugin_xml_parser.hpp"
+#include "./resolution_context.hpp"
+#include "./workspace_index.hpp"
 
 #ifdef _WIN32
 const std::string os_pathsep(";");  // NOLINT
@@ -68,37 +85,163 @@ namespace pluginlib
 template<class T>
 ClassLoader<T>::ClassLoader(
   std::string package, std::string base_class, std::string attrib_name,
-  std::vector<std::string> plugin_xml_paths)
+  std::vector<std::string> plugin_xml_paths, const DiscoveryOptions & options)
 : plugin_xml_paths_(plugin_xml_paths),
+  library_pins_(new LibraryPins()),
   package_(package),
   base_class_(base_class),
   attrib_name_(attrib_name),
+  options_(options),
   // NOTE: The parameter to the class loader enables/disables on-demand class
   // loading/unloading.
   // Leaving it off for now... libraries will be loaded immediately and won't
   // be unloaded until class loader is destroyed or force unload.
-  lowlevel_class_loader_(false)
+  lowlevel_class_loader_(false),
+  async_task_count_(0)
   /***************************************************************************/
 {
   ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Creating ClassLoader, base = %s, address = %p",
     base_class.c_str(), this);
-  if (ros::package::getPath(package_).empty()) {
-    throw pluginlib::ClassLoaderException("Unable to find package: " + package_);
+  boost::shared_ptr<boost::promise<void> > promise(new boost::promise<void>());
+  ready_ = promise->get_future().share();
+  if (options_.deferred) {
+    discovery_thread_.reset(new boost::thread(
+        boost::bind(&ClassLoader<T>::discoverInBackground, this, promise)));
+  } else {
+    discover();
+    promise->set_value();
   }
-
-  if (0 == plugin_xml_paths_.size()) {
-    plugin_xml_paths_ = getPluginXmlPaths(package_, attrib_name_);
+  if (options_.prefetch_libraries) {
+    prefetchLibraries();
   }
-  classes_available_ = determineAvailableClasses(plugin_xml_paths_);
   ROS_DEBUG_NAMED("pluginlib.ClassLoader",
     "Finished constructring ClassLoader, base = %s, address = %p",
     base_class.c_str(), this);
 }
 
+template<class T>
+void ClassLoader<T>::discover()
+/***************************************************************************/
+{
+  std::vector<std::string> plugin_xml_paths;
+  DiscoveryRegistry::EntryPtr discovery;
+  PluginCatalog::ConstPtr catalog;
+  {
+    boost::mutex::scoped_lock lock(classes_mutex_);
+    plugin_xml_paths = plugin_xml_paths_;
+  }
+
+  if (0 == plugin_xml_paths.size()) {
+    // Share the crawl and the parsed manifests with all loaders for the same package/attribute.
+    discovery = DiscoveryRegistry::instance().acquire(package_, attrib_name_, options_.backend);
+    boost::mutex::scoped_lock work_lock(discovery->work_mutex, boost::defer_lock);
+    for (;;) {
+      bool crawled = false;
+      PluginCatalog::ConstPtr previous;
+      {
+        boost::mutex::scoped_lock lock(discovery->mutex);
+        if (discovery->catalog && discovery->catalog->isComplete(base_class_)) {
+          plugin_xml_paths = discovery->plugin_xml_paths;
+          catalog = discovery->catalog;
+          break;
+        }
+        if (!work_lock.owns_lock()) {
+          // Wait for the loader at work, whose result may be all this one needs
+          lock.unlock();
+          work_lock.lock();
+          continue;
+        }
+        crawled = discovery->crawled;
+        plugin_xml_paths = discovery->plugin_xml_paths;
+        previous = discovery->catalog;
+      }
+
+      if (!crawled) {
+        if (getPackagePath(package_, options_.backend).empty()) {
+          throw pluginlib::ClassLoaderException("Unable to find package: " + package_);
+        }
+        plugin_xml_paths = getPluginXmlPaths(package_, attrib_name_, false, options_.backend);
+      }
+      // Parsed once for all base classes, whichever loader comes first. Manifests skipped for
+      // the base classes of earlier loaders are parsed when one needs them.
+      if (!previous) {
+        catalog.reset(new PluginCatalog(determineAvailableManifests(plugin_xml_paths)));
+      } else {
+        catalog.reset(new PluginCatalog(
+            determineAvailableManifests(plugin_xml_paths, previous->getManifests())));
+      }
+
+      boost::mutex::scoped_lock lock(discovery->mutex);
+      if (discovery->catalog != previous) {
+        // A refresh published newer results in the meantime, start over from those
+        continue;
+      }
+      discovery->crawled = true;
+      discovery->plugin_xml_paths = plugin_xml_paths;
+      discovery->catalog = catalog;
+      break;
+    }
+  } else {
+    if (getPackagePath(package_, options_.backend).empty()) {
+      throw pluginlib::ClassLoaderException("Unable to find package: " + package_);
+    }
+    catalog.reset(new PluginCatalog(determineAvailableManifests(plugin_xml_paths)));
+  }
+
+  boost::mutex::scoped_lock lock(classes_mutex_);
+  plugin_xml_paths_ = plugin_xml_paths;
+  discovery_ = discovery;
+  classes_available_ = catalog->getClasses(base_class_);
+  catalog_ = catalog;
+}
+
+template<class T>
+void ClassLoader<T>::discoverInBackground(boost::shared_ptr<boost::promise<void> > promise)
+/***************************************************************************/
+{
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Discovering plugins in the background, base = %s",
+    base_class_.c_str());
+  try {
+    discover();
+    promise->set_value();
+  } catch (const pluginlib::ClassLoaderException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+  } catch (const pluginlib::PluginlibException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+  } catch (const std::exception & ex) {
+    promise->set_exception(boost::copy_exception(pluginlib::ClassLoaderException(ex.what())));
+  }
+}
+
+template<class T>
+boost::shared_future<void> ClassLoader<T>::ready() const
+/***************************************************************************/
+{
+  return ready_;
+}
+
+template<class T>
+void ClassLoader<T>::waitForDiscovery() const
+/***************************************************************************/
+{
+  // Rethrows what discovery failed with, for every caller
+  ready_.get();
+}
+
 template<class T>
 ClassLoader<T>::~ClassLoader()
 /***************************************************************************/
 {
+  {
+    boost::mutex::scoped_lock lock(async_mutex_);
+    while (async_task_count_ > 0) {
+      async_condition_.wait(lock);
+    }
+  }
+  stopWatching();
+  if (discovery_thread_) {
+    discovery_thread_->join();
+  }
   ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Destroying ClassLoader, base = %s, address = %p",
     getBaseClassType().c_str(), this);
 }
@@ -113,16 +256,12 @@ T * ClassLoader<T>::createClassInstance(const std::string & lookup_name, bool au
     "In deprecated call createClassInstance(), lookup_name = %s, auto_load = %i.",
     (lookup_name.c_str()), auto_load);
 
-  if (auto_load && !isClassLoaded(lookup_name)) {
-    ROS_DEBUG_NAMED("pluginlib.ClassLoader",
-      "Autoloading class library before attempting to create instance.");
-    loadLibraryForClass(lookup_name);
-  }
+  std::string class_type = getClassTypeToCreate(lookup_name, auto_load);
 
   try {
     ROS_DEBUG_NAMED("pluginlib.ClassLoader",
       "Attempting to create instance through low-level MultiLibraryClassLoader...");
-    T * obj = lowlevel_class_loader_.createUnmanagedInstance<T>(getClassType(lookup_name));
+    T * obj = lowlevel_class_loader_.createUnmanagedInstance<T>(class_type);
     ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Instance created with object pointer = %p", obj);
 
     return obj;
@@ -140,12 +279,9 @@ boost::shared_ptr<T> ClassLoader<T>::createInstance(const std::string & lookup_n
   ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Attempting to create managed instance for class %s.",
     lookup_name.c_str());
 
-  if (!isClassLoaded(lookup_name)) {
-    loadLibraryForClass(lookup_name);
-  }
+  std::string class_type = getClassTypeToCreate(lookup_name, true);
 
   try {
-    std::string class_type = getClassType(lookup_name);
     ROS_DEBUG_NAMED("pluginlib.ClassLoader", "%s maps to real class type %s",
       lookup_name.c_str(), class_type.c_str());
 
@@ -172,12 +308,9 @@ UniquePtr<T> ClassLoader<T>::createUniqueInstance(const std::string & lookup_nam
     "Attempting to create managed (unique) instance for class %s.",
     lookup_name.c_str());
 
-  if (!isClassLoaded(lookup_name)) {
-    loadLibraryForClass(lookup_name);
-  }
+  std::string class_type = getClassTypeToCreate(lookup_name, true);
 
   try {
-    std::string class_type = getClassType(lookup_name);
     ROS_DEBUG_NAMED("pluginlib.ClassLoader", "%s maps to real class type %s",
       lookup_name.c_str(), class_type.c_str());
 
@@ -204,15 +337,12 @@ T * ClassLoader<T>::createUnmanagedInstance(const std::string & lookup_name)
   ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Attempting to create UNMANAGED instance for class %s.",
     lookup_name.c_str());
 
-  if (!isClassLoaded(lookup_name)) {
-    loadLibraryForClass(lookup_name);
-  }
+  std::string class_type = getClassTypeToCreate(lookup_name, true);
 
   T * instance = 0;
   try {
     ROS_DEBUG_NAMED("pluginlib.ClassLoader",
       "Attempting to create instance through low level multi-library class loader.");
-    std::string class_type = getClassType(lookup_name);
     ROS_DEBUG_NAMED("pluginlib.ClassLoader", "%s maps to real class type %s",
       lookup_name.c_str(), class_type.c_str());
     instance = lowlevel_class_loader_.createUnmanagedInstance<T>(class_type);
@@ -227,140 +357,423 @@ T * ClassLoader<T>::createUnmanagedInstance(const std::string & lookup_name)
   return instance;
 }
 
+template<class T>
+boost::shared_ptr<T> ClassLoader<T>::createInstance(const LookupKey & key)
+/***************************************************************************/
+{
+  std::string class_type = getClassTypeToCreate(key, true);
+  try {
+    return lowlevel_class_loader_.createInstance<T>(class_type);
+  } catch (const class_loader::CreateClassException & ex) {
+    throw pluginlib::CreateClassException(ex.what());
+  }
+}
+
+#if __cplusplus >= 201103L
+template<class T>
+UniquePtr<T> ClassLoader<T>::createUniqueInstance(const LookupKey & key)
+{
+  std::string class_type = getClassTypeToCreate(key, true);
+  try {
+    return lowlevel_class_loader_.createUniqueInstance<T>(class_type);
+  } catch (const class_loader::CreateClassException & ex) {
+    throw pluginlib::CreateClassException(ex.what());
+  }
+}
+#endif
+
+template<class T>
+T * ClassLoader<T>::createUnmanagedInstance(const LookupKey & key)
+/***************************************************************************/
+{
+  std::string class_type = getClassTypeToCreate(key, true);
+  try {
+    return lowlevel_class_loader_.createUnmanagedInstance<T>(class_type);
+  } catch (const class_loader::CreateClassException & ex) {
+    throw pluginlib::CreateClassException(ex.what());
+  }
+}
+
+template<class T>
+PluginHandle<T> ClassLoader<T>::getPluginHandle(const std::string & lookup_name)
+/***************************************************************************/
+{
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Resolving plugin handle for class %s.",
+    lookup_name.c_str());
+
+  // Records the path in resolved_library_paths_ even if another class loaded the library
+  loadLibraryForClass(lookup_name);
+  std::string class_type = getClassType(lookup_name);
+
+  std::string library_path;
+  {
+    boost::mutex::scoped_lock lock(library_mutex_);
+    std::map<std::string, std::string>::const_iterator it =
+      resolved_library_paths_.find(lookup_name);
+    if (it == resolved_library_paths_.end() ||
+      !lowlevel_class_loader_.isLibraryAvailable(it->second))
+    {
+      throw pluginlib::LibraryLoadException(
+              "The library of class " + lookup_name + " was unloaded while resolving its handle.");
+    }
+    library_path = it->second;
+
+    // Only a class this library registers with this loader may back the handle
+    std::vector<std::string> library_classes =
+      lowlevel_class_loader_.getAvailableClassesForLibrary<T>(library_path);
+    if (std::find(library_classes.begin(), library_classes.end(), class_type) ==
+      library_classes.end())
+    {
+      throw pluginlib::CreateClassException(
+              "Class " + class_type + " is not registered by library " + library_path + ". "
+              "Make sure that you are calling the PLUGINLIB_EXPORT_CLASS macro in the library "
+              "code, and that names are consistent between this macro and your XML.");
+    }
+
+    // The pin is taken under library_mutex_, so the library cannot be unloaded in between
+    library_pins_->acquire(library_path);
+  }
+
+  // Released together with the pin by releasePluginHandle(), which takes library_mutex_
+  typedef typename PluginHandle<T>::State HandleState;
+  return PluginHandle<T>(boost::shared_ptr<const HandleState>(
+             new HandleState(lookup_name, class_type, library_path, &lowlevel_class_loader_),
+             boost::bind(&ClassLoader<T>::releasePluginHandle, this, _1)));
+}
+
+template<class T>
+void ClassLoader<T>::releasePluginHandle(const typename PluginHandle<T>::State * state)
+/***************************************************************************/
+{
+  std::string library_path = state->library_path;
+  delete state;
+
+  boost::mutex::scoped_lock lock(library_mutex_);
+  if (!library_pins_->release(library_path)) {
+    return;
+  }
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader",
+    "Unloading library %s, whose last plugin handle was released.", library_path.c_str());
+  try {
+    lowlevel_class_loader_.unloadLibrary(library_path);
+  } catch (const std::exception & ex) {
+    ROS_ERROR_NAMED("pluginlib.ClassLoader", "Failed to unload library %s: %s",
+      library_path.c_str(), ex.what());
+  }
+}
+
 template<class T>
 std::vector<std::string> ClassLoader<T>::getPluginXmlPaths(
   const std::string & package,
   const std::string & attrib_name,
-  bool force_recrawl)
+  bool force_recrawl,
+  DiscoveryBackend backend)
 /***************************************************************************/
 {
   // Pull possible files from manifests of packages which depend on this package and export class
+  WorkspaceIndex::ConstPtr index = WorkspaceIndex::getActive();
+  if (index && !force_recrawl && !index->getPackagePath(package).empty()) {
+    return index->getPluginXmlPaths(package, attrib_name);
+  }
+  if (DISCOVERY_BACKEND_NATIVE == backend) {
+    return PackageCrawler::instance().getPlugins(package, attrib_name, force_recrawl);
+  }
   std::vector<std::string> paths;
   ros::package::getPlugins(package, attrib_name, paths, force_recrawl);
   return paths;
 }
 
 template<class T>
-std::map<std::string, ClassDesc> ClassLoader<T>::determineAvailableClasses(
-  const std::vector<std::string> & plugin_xml_paths)
+std::string ClassLoader<T>::getPackagePath(const std::string & package, DiscoveryBackend backend)
 /***************************************************************************/
 {
-  // mas - This method requires major refactoring...
-  // not only is it really long and confusing but a lot of the comments do not
-  // seem to be correct.
-  // With time I keep correcting small things, but a good rewrite is needed.
+  WorkspaceIndex::ConstPtr index = WorkspaceIndex::getActive();
+  if (index && !index->getPackagePath(package).empty()) {
+    return index->getPackagePath(package);
+  }
+  if (DISCOVERY_BACKEND_NATIVE == backend) {
+    return PackageCrawler::instance().getPath(package);
+  }
+  return ros::package::getPath(package);
+}
 
-  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Entering determineAvailableClasses()...");
-  std::map<std::string, ClassDesc> classes_available;
+template<class T>
+std::vector<PluginManifest> ClassLoader<T>::determineAvailableManifests(
+  const std::vector<std::string> & plugin_xml_paths,
+  const std::vector<PluginManifest> & previous)
+/***************************************************************************/
+{
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Entering determineAvailableManifests()...");
 
-  // Walk the list of all plugin XML files (variable "paths") that are exported by the build system
-  for (std::vector<std::string>::const_iterator it = plugin_xml_paths.begin();
-    it != plugin_xml_paths.end(); ++it)
+  std::map<std::string, const PluginManifest *> previous_by_path;
+  for (std::vector<PluginManifest>::const_iterator it = previous.begin(); it != previous.end();
+    ++it)
   {
-    try {
-      processSingleXMLPluginFile(*it, classes_available);
-    } catch (const pluginlib::InvalidXMLException & e) {
+    previous_by_path.insert(std::make_pair(it->path, &*it));
+  }
+
+  // Reuse what was parsed before for the manifests that did not change since
+  std::vector<ManifestStamp> stamps(plugin_xml_paths.size());
+  std::vector<PluginManifest> manifests(plugin_xml_paths.size());
+  std::vector<size_t> stamped;
+  WorkspaceIndex::ConstPtr workspace_index = WorkspaceIndex::getActive();
+  for (size_t i = 0; i < plugin_xml_paths.size(); ++i) {
+    // Files compiled into the running binaries or indexed ahead of time are neither stamped
+    // nor read
+    const CompiledManifest * compiled =
+      CompiledManifestRegistry::instance().find(plugin_xml_paths[i]);
+    if (compiled) {
+      manifests[i].path = plugin_xml_paths[i];
+      addCompiledClasses(*compiled, manifests[i]);
+      continue;
+    }
+    const WorkspaceIndex::Manifest * indexed =
+      workspace_index ? workspace_index->getManifest(plugin_xml_paths[i]) : NULL;
+    if (indexed) {
+      manifests[i].path = plugin_xml_paths[i];
+      addIndexedClasses(*indexed, manifests[i]);
+      continue;
+    }
+    stamped.push_back(i);
+  }
+
+  boost::scoped_ptr<BatchedFileIO> batched_io;
+  if (options_.batched_io && !stamped.empty()) {
+    batched_io.reset(new BatchedFileIO(
+        static_cast<unsigned int>(std::min<size_t>(stamped.size(), 256))));
+    if (!batched_io->isAvailable()) {
+      ROS_DEBUG_NAMED("pluginlib.ClassLoader", "io_uring is not available, not batching I/O.");
+      batched_io.reset();
+    }
+  }
+  std::vector<bool> stamp_taken(stamped.size(), false);
+  if (batched_io) {
+    std::vector<std::string> paths(stamped.size());
+    for (size_t j = 0; j < stamped.size(); ++j) {
+      paths[j] = plugin_xml_paths[stamped[j]];
+    }
+    std::vector<ManifestStamp> batch_stamps;
+    batched_io->stamp(paths, batch_stamps, stamp_taken);
+    for (size_t j = 0; j < stamped.size(); ++j) {
+      stamps[stamped[j]] = batch_stamps[j];
+    }
+  }
+
+  std::vector<PluginManifest *> pending;
+  for (size_t j = 0; j < stamped.size(); ++j) {
+    size_t i = stamped[j];
+    if (!stamp_taken[j]) {
+      stamps[i] = ManifestStamp::of(plugin_xml_paths[i]);
+    }
+    std::map<std::string, const PluginManifest *>::const_iterator previous_it =
+      previous_by_path.find(plugin_xml_paths[i]);
+    if (previous_it != previous_by_path.end() && previous_it->second->stamp == stamps[i]) {
+      manifests[i] = *previous_it->second;
+      if (manifests[i].isComplete(base_class_)) {
+        continue;
+      }
+    } else {
+      manifests[i].path = plugin_xml_paths[i];
+      manifests[i].stamp = stamps[i];
+    }
+    pending.push_back(&manifests[i]);
+  }
+  if (pending.empty()) {
+    return manifests;
+  }
+
+  // Reuse the on-disk index when none of the manifests changed since it was written.
+  PluginIndexCache index_cache(package_, attrib_name_);
+  std::vector<PluginManifest> cached_manifests;
+  if (index_cache.load(plugin_xml_paths, stamps, cached_manifests)) {
+    pending.clear();
+    for (size_t i = 0; i < cached_manifests.size(); ++i) {
+      if (!cached_manifests[i].isComplete(base_class_)) {
+        pending.push_back(&cached_manifests[i]);
+      }
+    }
+    if (pending.empty()) {
+      return cached_manifests;
+    }
+    manifests.swap(cached_manifests);
+  }
+
+  // Walk the list of plugin XML files (variable "paths") that are exported by the build system
+  // and changed, spreading the files over a bounded number of threads
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Parsing %u of %u plugin manifests.",
+    static_cast<unsigned int>(pending.size()), static_cast<unsigned int>(manifests.size()));
+  std::vector<ManifestParseResult> results(pending.size());
+  if (batched_io) {
+    prefetchManifests(*batched_io, pending, results);
+  }
+  parallelFor(pending.size(), getDiscoveryThreadCount(),
+    boost::bind(&ClassLoader<T>::parseManifest, this, &pending, &results, _1));
+
+  // Report errors in manifest order, as a serial walk would have
+  size_t skipped = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (!pending[i]->parsed && results[i].error.empty()) {
+      ++skipped;
+    }
+    if (results[i].fatal) {
+      throw pluginlib::ClassLoaderException(results[i].error);
+    }
+    if (!results[i].error.empty()) {
       ROS_ERROR_NAMED("pluginlib.ClassLoader",
         "Skipped loading plugin with error: %s.",
-        e.what());
+        results[i].error.c_str());
     }
   }
+  index_cache.store(manifests);
 
-  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Exiting determineAvailableClasses()...");
-  return classes_available;
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader",
+    "Skipped %u plugin manifests which declare no class of type %s.",
+    static_cast<unsigned int>(skipped), base_class_.c_str());
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Exiting determineAvailableManifests()...");
+  return manifests;
 }
 
 template<class T>
-std::string ClassLoader<T>::extractPackageNameFromPackageXML(const std::string & package_xml_path)
+void ClassLoader<T>::addCompiledClasses(
+  const CompiledManifest & compiled, PluginManifest & manifest)
 /***************************************************************************/
 {
-  tinyxml2::XMLDocument document;
-  document.LoadFile(package_xml_path.c_str());
-  tinyxml2::XMLElement * doc_root_node = document.FirstChildElement("package");
-  if (NULL == doc_root_node) {
-    ROS_ERROR_NAMED("pluginlib.ClassLoader",
-      "Could not find a root element for package manifest at %s.",
-      package_xml_path.c_str());
-    return "";
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Using the compiled table of xml file %s.",
+    manifest.path.c_str());
+  for (size_t i = 0; i < compiled.class_count; ++i) {
+    const CompiledClass & compiled_class = compiled.classes[i];
+    manifest.classes[compiled_class.base_class_type].insert(
+      std::pair<std::string, ClassDesc>(compiled_class.lookup_name,
+      ClassDesc(compiled_class.lookup_name, compiled_class.type, compiled_class.base_class_type,
+      compiled.package, compiled_class.description, compiled_class.library_path,
+      manifest.path)));
   }
+}
 
-  assert(document.RootElement() == doc_root_node);
-
-  tinyxml2::XMLElement * package_name_node = doc_root_node->FirstChildElement("name");
-  if (NULL == package_name_node) {
-    ROS_ERROR_NAMED("pluginlib.ClassLoader",
-      "package.xml at %s does not have a <name> tag! Cannot determine package "
-      "which exports plugin.",
-      package_xml_path.c_str());
-    return "";
+template<class T>
+void ClassLoader<T>::addIndexedClasses(
+  const WorkspaceIndex::Manifest & indexed, PluginManifest & manifest)
+/***************************************************************************/
+{
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Using the indexed classes of xml file %s.",
+    manifest.path.c_str());
+  for (size_t i = 0; i < indexed.classes.size(); ++i) {
+    const ClassDesc & desc = indexed.classes[i];
+    manifest.classes[desc.base_class_].insert(
+      std::pair<std::string, ClassDesc>(desc.lookup_name_, desc));
   }
+}
 
-  return package_name_node->GetText();
+template<class T>
+bool ClassLoader<T>::isClassDescChanged(
+  const ClassDescRef & old_desc, const ClassDescRef & new_desc)
+/***************************************************************************/
+{
+  // A deferred description nobody has read yet cannot have changed for anybody
+  return 0 != std::strcmp(old_desc.getDerivedClass(), new_desc.getDerivedClass()) ||
+         0 != std::strcmp(old_desc.getBaseClass(), new_desc.getBaseClass()) ||
+         0 != std::strcmp(old_desc.getPackage(), new_desc.getPackage()) ||
+         (old_desc.isDescriptionRead() &&
+         0 != std::strcmp(old_desc.getDescription(), new_desc.getDescription())) ||
+         0 != std::strcmp(old_desc.getLibraryName(), new_desc.getLibraryName()) ||
+         0 != std::strcmp(old_desc.getPluginManifestPath(), new_desc.getPluginManifestPath());
 }
 
 template<class T>
-std::vector<std::string> ClassLoader<T>::getCatkinLibraryPaths()
+void ClassLoader<T>::parseManifest(
+  std::vector<PluginManifest *> * manifests,
+  std::vector<ManifestParseResult> * results,
+  size_t index)
 /***************************************************************************/
 {
-  std::vector<std::string> lib_paths;
-  const char * env = std::getenv("CMAKE_PREFIX_PATH");
-  if (env) {
-    std::string env_catkin_prefix_paths(env);
-    std::vector<std::string> catkin_prefix_paths;
-    boost::split(catkin_prefix_paths, env_catkin_prefix_paths, boost::is_any_of(os_pathsep));
-    BOOST_FOREACH(std::string catkin_prefix_path, catkin_prefix_paths) {
-      boost::filesystem::path path(catkin_prefix_path);
-      boost::filesystem::path lib("lib");
-      lib_paths.push_back((path / lib).string());
+  PluginManifest & manifest = *(*manifests)[index];
+  ManifestParseResult & result = (*results)[index];
+  try {
+    // Most manifests declare nothing for a given base class, which the raw bytes tell cheaply
+    if (result.prefetched) {
+      const char * data = &result.contents[0];
+      if (!PluginXMLParser::mayDeclareBaseClass(data, result.contents.size(), base_class_)) {
+        manifest.parsed = false;
+        manifest.absent_base_classes.insert(base_class_);
+        return;
+      }
+      manifest.parsed = true;
+      manifest.absent_base_classes.clear();
+      processSingleXMLPluginFile(manifest.path, data, result.contents.size(), manifest.classes);
+      std::vector<char>().swap(result.contents);
+      return;
     }
+    {
+      MappedFile file(manifest.path);
+      if (file.isOpen() &&
+        !PluginXMLParser::mayDeclareBaseClass(file.data(), file.size(), base_class_))
+      {
+        manifest.parsed = false;
+        manifest.absent_base_classes.insert(base_class_);
+        return;
+      }
+    }
+    manifest.parsed = true;
+    manifest.absent_base_classes.clear();
+    processSingleXMLPluginFile(manifest.path, manifest.classes);
+  } catch (const pluginlib::InvalidXMLException & e) {
+    // Left to be parsed, and reported, again rather than cached as declaring nothing
+    manifest.parsed = false;
+    manifest.absent_base_classes.clear();
+    manifest.classes.clear();
+    result.error = e.what();
+  } catch (const std::exception & e) {
+    result.fatal = true;
+    result.error = e.what();
   }
-  return lib_paths;
 }
 
 template<class T>
-std::vector<std::string> ClassLoader<T>::getAllLibraryPathsToTry(
-  const std::string & library_name,
-  const std::string & exporting_package_name)
+void ClassLoader<T>::prefetchManifests(
+  BatchedFileIO & batched_io, const std::vector<PluginManifest *> & manifests,
+  std::vector<ManifestParseResult> & results)
 /***************************************************************************/
 {
-  // Catkin-rosbuild Backwards Compatability Rules - Note library_name may be prefixed with
-  // relative path (e.g. "/lib/libFoo")
-  // 1. Try catkin library paths (catkin_find --libs) + library_name + extension
-  // 2. Try catkin library paths
-  //   (catkin_find -- libs) + stripAllButFileFromPath(library_name) + extension
-  // 3. Try export_pkg/library_name + extension
-
-  std::vector<std::string> all_paths;
-  std::vector<std::string> all_paths_without_extension = getCatkinLibraryPaths();
-  all_paths_without_extension.push_back(getROSBuildLibraryPath(exporting_package_name));
-  bool debug_library_suffix = (0 == class_loader::systemLibrarySuffix().compare(0, 1, "d"));
-  std::string non_debug_suffix;
-  if (debug_library_suffix) {
-    non_debug_suffix = class_loader::systemLibrarySuffix().substr(1);
-  } else {
-    non_debug_suffix = class_loader::systemLibrarySuffix();
+  std::vector<std::string> paths(manifests.size());
+  std::vector<boost::uint64_t> sizes(manifests.size());
+  for (size_t i = 0; i < manifests.size(); ++i) {
+    paths[i] = manifests[i]->path;
+    sizes[i] = manifests[i]->stamp.size;
   }
-  std::string library_name_with_extension = library_name + non_debug_suffix;
-  std::string stripped_library_name = stripAllButFileFromPath(library_name);
-  std::string stripped_library_name_with_extension = stripped_library_name + non_debug_suffix;
-
-  const std::string path_separator = getPathSeparator();
-
-  for (unsigned int c = 0; c < all_paths_without_extension.size(); c++) {
-    std::string current_path = all_paths_without_extension.at(c);
-    all_paths.push_back(current_path + path_separator + library_name_with_extension);
-    all_paths.push_back(current_path + path_separator + stripped_library_name_with_extension);
-    // We're in debug mode, try debug libraries as well
-    if (debug_library_suffix) {
-      all_paths.push_back(
-        current_path + path_separator + library_name + class_loader::systemLibrarySuffix());
-      all_paths.push_back(
-        current_path + path_separator + stripped_library_name +
-        class_loader::systemLibrarySuffix());
+  std::vector<std::vector<char> > contents;
+  std::vector<bool> read;
+  batched_io.read(paths, sizes, contents, read);
+  // The files not read, or empty, are mapped when parsed as usual
+  for (size_t i = 0; i < manifests.size(); ++i) {
+    if (read[i] && !contents[i].empty()) {
+      results[i].prefetched = true;
+      results[i].contents.swap(contents[i]);
     }
   }
+}
+
+template<class T>
+std::string ClassLoader<T>::extractPackageNameFromPackageXML(const std::string & package_xml_path)
+/***************************************************************************/
+{
+  return PackageDirectoryCache::extractPackageNameFromPackageXML(package_xml_path);
+}
+
+template<class T>
+std::vector<std::string> ClassLoader<T>::getCatkinLibraryPaths()
+/***************************************************************************/
+{
+  return ResolutionContext::getCurrent()->getCatkinLibraryPaths();
+}
 
-  return all_paths;
+template<class T>
+std::vector<std::string> ClassLoader<T>::getAllLibraryPathsToTry(
+  const std::string & library_name,
+  const std::string & exporting_package_name)
+/***************************************************************************/
+{
+  return LibraryPathResolver::getAllLibraryPathsToTry(
+    library_name, getROSBuildLibraryPath(exporting_package_name), getCatkinLibraryPaths());
 }
 
 template<class T>
@@ -381,9 +794,10 @@ template<class T>
 std::string ClassLoader<T>::getClassDescription(const std::string & lookup_name)
 /***************************************************************************/
 {
-  ClassMapIterator it = classes_available_.find(lookup_name);
-  if (it != classes_available_.end()) {
-    return it->second.description_;
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  if (desc.isValid()) {
+    return desc.getDescription();
   }
   return "";
 }
@@ -392,9 +806,10 @@ template<class T>
 std::string ClassLoader<T>::getClassType(const std::string & lookup_name)
 /***************************************************************************/
 {
-  ClassMapIterator it = classes_available_.find(lookup_name);
-  if (it != classes_available_.end()) {
-    return it->second.derived_class_;
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  if (desc.isValid()) {
+    return desc.getDerivedClass();
   }
   return "";
 }
@@ -403,42 +818,39 @@ template<class T>
 std::string ClassLoader<T>::getClassLibraryPath(const std::string & lookup_name)
 /***************************************************************************/
 {
-  if (classes_available_.find(lookup_name) == classes_available_.end()) {
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  if (!desc.isValid()) {
     ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Class %s has no mapping in classes_available_.",
       lookup_name.c_str());
     return "";
   }
-  ClassMapIterator it = classes_available_.find(lookup_name);
-  std::string library_name = it->second.library_name_;
-  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Class %s maps to library %s in classes_available_.",
-    lookup_name.c_str(), library_name.c_str());
+  return getClassLibraryPath(desc);
+}
 
-  std::vector<std::string> paths_to_try =
-    getAllLibraryPathsToTry(library_name, it->second.package_);
+template<class T>
+std::string ClassLoader<T>::getClassLibraryPath(const ClassDescRef & desc)
+/***************************************************************************/
+{
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Class %s maps to library %s in classes_available_.",
+    desc.getLookupName(), desc.getLibraryName());
 
-  ROS_DEBUG_NAMED("pluginlib.ClassLoader",
-    "Iterating through all possible paths where %s could be located...",
-    library_name.c_str());
-  for (std::vector<std::string>::const_iterator it = paths_to_try.begin(); it != paths_to_try.end();
-    it++)
-  {
-    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Checking path %s ", it->c_str());
-    if (boost::filesystem::exists(*it)) {
-      ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Library %s found at explicit path %s.",
-        library_name.c_str(), it->c_str());
-      return *it;
-    }
+  // Descriptions read from a workspace index come with the path already resolved
+  std::string resolved_library_path = desc.getResolvedLibraryPath();
+  if (!resolved_library_path.empty() && "UNRESOLVED" != resolved_library_path) {
+    return resolved_library_path;
   }
-  return "";
+  return LibraryPathCache::instance().resolve(desc.getLibraryName(), desc.getPackage());
 }
 
 template<class T>
 std::string ClassLoader<T>::getClassPackage(const std::string & lookup_name)
 /***************************************************************************/
 {
-  ClassMapIterator it = classes_available_.find(lookup_name);
-  if (it != classes_available_.end()) {
-    return it->second.package_;
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  if (desc.isValid()) {
+    return desc.getPackage();
   }
   return "";
 }
@@ -447,6 +859,8 @@ template<class T>
 std::vector<std::string> ClassLoader<T>::getPluginXmlPaths()
 /***************************************************************************/
 {
+  waitForDiscovery();
+  boost::mutex::scoped_lock lock(classes_mutex_);
   return plugin_xml_paths_;
 }
 
@@ -455,13 +869,24 @@ std::vector<std::string> ClassLoader<T>::getDeclaredClasses()
 /***************************************************************************/
 {
   std::vector<std::string> lookup_names;
-  for (ClassMapIterator it = classes_available_.begin(); it != classes_available_.end(); ++it) {
-    lookup_names.push_back(it->first);
+  DiscoveryRegistry::ClassMapPtr classes = getClassesAvailable();
+  lookup_names.reserve(classes->size());
+  for (size_t i = 0; i < classes->size(); ++i) {
+    lookup_names.push_back((*classes)[i].getLookupName());
   }
 
   return lookup_names;
 }
 
+template<class T>
+PluginCatalog::ConstPtr ClassLoader<T>::getPluginCatalog()
+/***************************************************************************/
+{
+  waitForDiscovery();
+  boost::mutex::scoped_lock lock(classes_mutex_);
+  return catalog_;
+}
+
 template<class T>
 std::string ClassLoader<T>::getErrorStringForUnknownClass(const std::string & lookup_name)
 /***************************************************************************/
@@ -479,11 +904,17 @@ std::string ClassLoader<T>::getErrorStringForUnknownClass(const std::string & lo
 template<class T>
 std::string ClassLoader<T>::getName(const std::string & lookup_name)
 /***************************************************************************/
+{
+  return getNameView(lookup_name).to_string();
+}
+
+template<class T>
+boost::string_view ClassLoader<T>::getNameView(boost::string_view lookup_name)
+/***************************************************************************/
 {
   // remove the package name to get the raw plugin name
-  std::vector<std::string> split;
-  boost::split(split, lookup_name, boost::is_any_of("/:"));
-  return split.back();
+  size_t separator = lookup_name.find_last_of("/:");
+  return boost::string_view::npos == separator ? lookup_name : lookup_name.substr(separator + 1);
 }
 
 template<class T>
@@ -506,51 +937,15 @@ ClassLoader<T>::getPackageFromPluginXMLFilePath(const std::string & plugin_xml_f
   // 1. Find nearest encasing package.xml
   // 2. Extract name of package from package.xml
 
-  std::string package_name;
-  boost::filesystem::path p(plugin_xml_file_path);
-  boost::filesystem::path parent = p.parent_path();
-
-  // Figure out exactly which package the passed XML file is exported by.
-  while (true) {
-    if (boost::filesystem::exists(parent / "package.xml")) {
-      std::string package_file_path = (boost::filesystem::path(parent / "package.xml")).string();
-      return extractPackageNameFromPackageXML(package_file_path);
-    } else if (boost::filesystem::exists(parent / "manifest.xml")) {
-#if BOOST_FILESYSTEM_VERSION >= 3
-      std::string package = parent.filename().string();
-#else
-      std::string package = parent.filename();
-#endif
-      std::string package_path = ros::package::getPath(package);
-
-      // package_path is a substr of passed plugin xml path
-      if (0 == plugin_xml_file_path.find(package_path)) {
-        package_name = package;
-        break;
-      }
-    }
-
-    // Recursive case - hop one folder up
-    parent = parent.parent_path().string();
-
-    // Base case - reached root and cannot find what we're looking for
-    if (parent.string().empty()) {
-      return "";
-    }
-  }
-
-  return package_name;
+  // The directories on the way are probed only once per process and shared by all loaders.
+  return PackageDirectoryCache::instance().getPackageFromPluginXMLFilePath(plugin_xml_file_path);
 }
 
 template<class T>
 std::string ClassLoader<T>::getPathSeparator()
 /***************************************************************************/
 {
-#if BOOST_FILESYSTEM_VERSION >= 3
-  return boost::filesystem::path("/").native();
-#else
-  return boost::filesystem::path("/").external_file_string();
-#endif
+  return LibraryPathResolver::getPathSeparator();
 }
 
 
@@ -558,9 +953,10 @@ template<class T>
 std::string ClassLoader<T>::getPluginManifestPath(const std::string & lookup_name)
 /***************************************************************************/
 {
-  ClassMapIterator it = classes_available_.find(lookup_name);
-  if (it != classes_available_.end()) {
-    return it->second.plugin_manifest_path_;
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  if (desc.isValid()) {
+    return desc.getPluginManifestPath();
   }
   return "";
 }
@@ -577,67 +973,491 @@ template<class T>
 std::string ClassLoader<T>::getROSBuildLibraryPath(const std::string & exporting_package_name)
 /***************************************************************************/
 {
-  return ros::package::getPath(exporting_package_name);
+  return ResolutionContext::getCurrent()->getPackagePath(exporting_package_name);
 }
 
 template<class T>
 bool ClassLoader<T>::isClassAvailable(const std::string & lookup_name)
 /***************************************************************************/
 {
-  return classes_available_.find(lookup_name) != classes_available_.end();
+  return isClassAvailable(boost::string_view(lookup_name));
 }
 
 template<class T>
-std::string ClassLoader<T>::joinPaths(const std::string & path1, const std::string & path2)
+bool ClassLoader<T>::isClassAvailable(const char * lookup_name)
 /***************************************************************************/
 {
-  boost::filesystem::path p1(path1);
-  return (p1 / path2).string();
+  return isClassAvailable(boost::string_view(lookup_name));
 }
 
 template<class T>
-void ClassLoader<T>::loadLibraryForClass(const std::string & lookup_name)
+bool ClassLoader<T>::isClassAvailable(boost::string_view lookup_name)
 /***************************************************************************/
 {
-  ClassMapIterator it = classes_available_.find(lookup_name);
-  if (it == classes_available_.end()) {
-    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Class %s has no mapping in classes_available_.",
-      lookup_name.c_str());
-    throw pluginlib::LibraryLoadException(getErrorStringForUnknownClass(lookup_name));
-  }
-
-  std::string library_path = getClassLibraryPath(lookup_name);
-  if ("" == library_path) {
-    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "No path could be found to the library containing %s.",
-      lookup_name.c_str());
-    std::ostringstream error_msg;
-    error_msg << "Could not find library corresponding to plugin " << lookup_name <<
-      ". Make sure the plugin description XML file has the correct name of the "
-      "library and that the library actually exists.";
-    throw pluginlib::LibraryLoadException(error_msg.str());
-  }
-
-  try {
-    lowlevel_class_loader_.loadLibrary(library_path);
-    it->second.resolved_library_path_ = library_path;
-  } catch (const class_loader::LibraryLoadException & ex) {
-    std::string error_string =
-      "Failed to load library " + library_path + ". "
-      "Make sure that you are calling the PLUGINLIB_EXPORT_CLASS macro in the "
-      "library code, and that names are consistent between this macro and your XML. "
-      "Error string: " + ex.what();
-    throw pluginlib::LibraryLoadException(error_string);
-  }
+  DiscoveryRegistry::ClassMapPtr classes;
+  return findClass(lookup_name, classes).isValid();
 }
 
 template<class T>
-void ClassLoader<T>::processSingleXMLPluginFile(
-  const std::string & xml_file, std::map<std::string,
-  ClassDesc> & classes_available)
+bool ClassLoader<T>::isClassAvailable(const LookupKey & key)
 /***************************************************************************/
 {
-  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Processing xml file %s...", xml_file.c_str());
-  tinyxml2::XMLDocument document;
+  DiscoveryRegistry::ClassMapPtr classes;
+  return findClass(key, classes).isValid();
+}
+
+template<class T>
+boost::string_view ClassLoader<T>::getClassTypeView(boost::string_view lookup_name) const
+/***************************************************************************/
+{
+  // The table stays alive until a refresh replaces it, see classes_available_
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  return desc.isValid() ? boost::string_view(desc.getDerivedClass()) : boost::string_view();
+}
+
+template<class T>
+boost::string_view ClassLoader<T>::getClassTypeView(const LookupKey & key) const
+/***************************************************************************/
+{
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(key, classes);
+  return desc.isValid() ? boost::string_view(desc.getDerivedClass()) : boost::string_view();
+}
+
+template<class T>
+boost::string_view ClassLoader<T>::getClassDescriptionView(boost::string_view lookup_name) const
+/***************************************************************************/
+{
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  return desc.isValid() ? boost::string_view(desc.getDescription()) : boost::string_view();
+}
+
+template<class T>
+boost::string_view ClassLoader<T>::getClassPackageView(boost::string_view lookup_name) const
+/***************************************************************************/
+{
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  return desc.isValid() ? boost::string_view(desc.getPackage()) : boost::string_view();
+}
+
+template<class T>
+boost::string_view ClassLoader<T>::getPluginManifestPathView(
+  boost::string_view lookup_name) const
+/***************************************************************************/
+{
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  return desc.isValid() ? boost::string_view(desc.getPluginManifestPath()) : boost::string_view();
+}
+
+template<class T>
+std::string ClassLoader<T>::getClassTypeToCreate(const std::string & lookup_name, bool auto_load)
+/***************************************************************************/
+{
+  // One lookup for the type, which class_loader needs as a std::string, and the loaded check
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  if (!desc.isValid()) {
+    throw pluginlib::LibraryLoadException(getErrorStringForUnknownClass(lookup_name));
+  }
+  boost::string_view type(desc.getDerivedClass());
+  std::string class_type(type.data(), type.size());
+  if (auto_load && !lowlevel_class_loader_.isClassAvailable<T>(class_type)) {
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader",
+      "Autoloading class library before attempting to create instance.");
+    loadLibraryForClass(lookup_name);
+  }
+  return class_type;
+}
+
+template<class T>
+std::string ClassLoader<T>::getClassTypeToCreate(const LookupKey & key, bool auto_load)
+/***************************************************************************/
+{
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(key, classes);
+  if (!desc.isValid()) {
+    throw pluginlib::LibraryLoadException(getErrorStringForUnknownClass(key.getName().to_string()));
+  }
+  boost::string_view type(desc.getDerivedClass());
+  std::string class_type(type.data(), type.size());
+  if (auto_load && !lowlevel_class_loader_.isClassAvailable<T>(class_type)) {
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader",
+      "Autoloading class library before attempting to create instance.");
+    loadLibraryForClass(key.getName().to_string());
+  }
+  return class_type;
+}
+
+template<class T>
+std::string ClassLoader<T>::joinPaths(const std::string & path1, const std::string & path2)
+/***************************************************************************/
+{
+  boost::filesystem::path p1(path1);
+  return (p1 / path2).string();
+}
+
+template<class T>
+void ClassLoader<T>::loadLibraryForClass(const std::string & lookup_name)
+/***************************************************************************/
+{
+  loadClassLibraryInternal(getLibraryPathToLoad(lookup_name),
+    std::vector<std::string>(1, lookup_name));
+}
+
+template<class T>
+std::string ClassLoader<T>::getLibraryPathToLoad(const std::string & lookup_name)
+/***************************************************************************/
+{
+  DiscoveryRegistry::ClassMapPtr classes;
+  ClassDescRef desc = findClass(lookup_name, classes);
+  if (!desc.isValid()) {
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Class %s has no mapping in classes_available_.",
+      lookup_name.c_str());
+    throw pluginlib::LibraryLoadException(getErrorStringForUnknownClass(lookup_name));
+  }
+
+  std::string library_path = getClassLibraryPath(desc);
+  if ("" == library_path) {
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "No path could be found to the library containing %s.",
+      lookup_name.c_str());
+    std::ostringstream error_msg;
+    error_msg << "Could not find library corresponding to plugin " << lookup_name <<
+      ". Make sure the plugin description XML file has the correct name of the "
+      "library and that the library actually exists.";
+    throw pluginlib::LibraryLoadException(error_msg.str());
+  }
+  return library_path;
+}
+
+template<class T>
+void ClassLoader<T>::loadClassLibraryInternal(
+  const std::string & library_path, const std::vector<std::string> & lookup_names)
+/***************************************************************************/
+{
+  try {
+    boost::mutex::scoped_lock lock(library_mutex_);
+    lowlevel_class_loader_.loadLibrary(library_path);
+    // Loaded again, the library stays loaded after its plugin handles are released
+    library_pins_->cancelUnload(library_path);
+    for (size_t i = 0; i < lookup_names.size(); ++i) {
+      resolved_library_paths_[lookup_names[i]] = library_path;
+    }
+  } catch (const class_loader::LibraryLoadException & ex) {
+    std::string error_string =
+      "Failed to load library " + library_path + ". "
+      "Make sure that you are calling the PLUGINLIB_EXPORT_CLASS macro in the "
+      "library code, and that names are consistent between this macro and your XML. "
+      "Error string: " + ex.what();
+    throw pluginlib::LibraryLoadException(error_string);
+  }
+
+  // Loaded classes keep their descriptions across refreshes, see refreshClasses(). Read the
+  // deferred ones now, so that they are not taken from a manifest edited in the meantime.
+  for (size_t i = 0; i < lookup_names.size(); ++i) {
+    DiscoveryRegistry::ClassMapPtr classes;
+    ClassDescRef desc = findClass(lookup_names[i], classes);
+    if (desc.isValid()) {
+      desc.getDescription();
+    }
+  }
+}
+
+template<class T>
+boost::shared_future<void> ClassLoader<T>::loadLibraryForClassAsync(
+  const std::string & lookup_name)
+/***************************************************************************/
+{
+  return loadLibraryForClassAsync(lookup_name, getExecutor());
+}
+
+template<class T>
+boost::shared_future<void> ClassLoader<T>::loadLibraryForClassAsync(
+  const std::string & lookup_name, const Executor::Ptr & executor)
+/***************************************************************************/
+{
+  boost::shared_ptr<boost::promise<void> > promise(new boost::promise<void>());
+  boost::shared_future<void> done = promise->get_future().share();
+  std::string library_path;
+  try {
+    library_path = getLibraryPathToLoad(lookup_name);
+  } catch (const pluginlib::LibraryLoadException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+    return done;
+  } catch (const pluginlib::ClassLoaderException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+    return done;
+  }
+
+  {
+    boost::mutex::scoped_lock lock(async_mutex_);
+    typename std::map<std::string, LibraryLoad>::iterator it = library_loads_.find(library_path);
+    if (it != library_loads_.end()) {
+      ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Joining the load of library %s in flight.",
+        library_path.c_str());
+      it->second.lookup_names.push_back(lookup_name);
+      return it->second.done;
+    }
+    LibraryLoad & load = library_loads_[library_path];
+    load.done = done;
+    load.lookup_names.push_back(lookup_name);
+  }
+  startAsyncTask();
+  try {
+    executor->post(boost::bind(&ClassLoader<T>::runLibraryLoad, this, library_path, promise));
+  } catch (...) {
+    endLibraryLoad(library_path);
+    finishAsyncTask();
+    throw;
+  }
+  return done;
+}
+
+template<class T>
+void ClassLoader<T>::runLibraryLoad(
+  const std::string & library_path, boost::shared_ptr<boost::promise<void> > promise)
+/***************************************************************************/
+{
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Loading library %s asynchronously.",
+    library_path.c_str());
+  try {
+    loadClassLibraryInternal(library_path, std::vector<std::string>());
+    // Record the classes asked for, also while the library was loading, quickly now it is loaded
+    loadClassLibraryInternal(library_path, endLibraryLoad(library_path));
+    promise->set_value();
+  } catch (const pluginlib::LibraryLoadException & ex) {
+    endLibraryLoad(library_path);
+    promise->set_exception(boost::copy_exception(ex));
+  } catch (...) {
+    // Anything else is passed on as it is, as by runCreateInstance()
+    endLibraryLoad(library_path);
+    promise->set_exception(boost::current_exception());
+  }
+  finishAsyncTask();
+}
+
+template<class T>
+std::vector<std::string> ClassLoader<T>::endLibraryLoad(const std::string & library_path)
+/***************************************************************************/
+{
+  std::vector<std::string> lookup_names;
+  boost::mutex::scoped_lock lock(async_mutex_);
+  typename std::map<std::string, LibraryLoad>::iterator it = library_loads_.find(library_path);
+  if (it != library_loads_.end()) {
+    lookup_names.swap(it->second.lookup_names);
+    library_loads_.erase(it);
+  }
+  return lookup_names;
+}
+
+template<class T>
+boost::shared_future<boost::shared_ptr<T> > ClassLoader<T>::createInstanceAsync(
+  const std::string & lookup_name)
+/***************************************************************************/
+{
+  return createInstanceAsync(lookup_name, getExecutor());
+}
+
+template<class T>
+boost::shared_future<boost::shared_ptr<T> > ClassLoader<T>::createInstanceAsync(
+  const std::string & lookup_name, const Executor::Ptr & executor)
+/***************************************************************************/
+{
+  boost::shared_ptr<boost::promise<boost::shared_ptr<T> > > promise(
+    new boost::promise<boost::shared_ptr<T> >());
+  boost::shared_future<boost::shared_ptr<T> > instance = promise->get_future().share();
+  startAsyncTask();
+  try {
+    // A load of the library in flight holds library_mutex_, which createInstance() waits for
+    executor->post(boost::bind(&ClassLoader<T>::runCreateInstance, this, lookup_name, promise));
+  } catch (...) {
+    finishAsyncTask();
+    throw;
+  }
+  return instance;
+}
+
+template<class T>
+void ClassLoader<T>::runCreateInstance(
+  const std::string & lookup_name,
+  boost::shared_ptr<boost::promise<boost::shared_ptr<T> > > promise)
+/***************************************************************************/
+{
+  try {
+    promise->set_value(createInstance(lookup_name));
+  } catch (const pluginlib::LibraryLoadException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+  } catch (const pluginlib::CreateClassException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+  } catch (const pluginlib::ClassLoaderException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+  } catch (...) {
+    // Anything else is passed on as it is, not disguised as a failure to create the instance
+    promise->set_exception(boost::current_exception());
+  }
+  finishAsyncTask();
+}
+
+template<class T>
+boost::shared_future<void> ClassLoader<T>::prefetchLibraries()
+/***************************************************************************/
+{
+  return prefetchLibraries(getExecutor());
+}
+
+template<class T>
+boost::shared_future<void> ClassLoader<T>::prefetchLibraries(const Executor::Ptr & executor)
+/***************************************************************************/
+{
+  boost::shared_ptr<boost::promise<void> > promise(new boost::promise<void>());
+  boost::shared_future<void> done = promise->get_future().share();
+  startAsyncTask();
+  try {
+    executor->post(boost::bind(&ClassLoader<T>::runPrefetchLibraries, this, promise));
+  } catch (...) {
+    finishAsyncTask();
+    throw;
+  }
+  return done;
+}
+
+template<class T>
+void ClassLoader<T>::runPrefetchLibraries(boost::shared_ptr<boost::promise<void> > promise)
+/***************************************************************************/
+{
+  try {
+    // Waits for deferred discovery
+    DiscoveryRegistry::ClassMapPtr classes = getClassesAvailable();
+    std::set<std::string> seen;
+    std::vector<std::string> library_paths;
+    for (size_t i = 0; i < classes->size(); ++i) {
+      std::string library_path = getClassLibraryPath((*classes)[i]);
+      if (!library_path.empty() && seen.insert(library_path).second) {
+        library_paths.push_back(library_path);
+      }
+    }
+    LibraryPrefetcher prefetcher;
+    size_t count = prefetcher.prefetch(library_paths);
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader",
+      "Prefetched %u files for the %u libraries of base class %s.",
+      static_cast<unsigned int>(count), static_cast<unsigned int>(library_paths.size()),
+      base_class_.c_str());
+    promise->set_value();
+  } catch (const pluginlib::ClassLoaderException & ex) {
+    promise->set_exception(boost::copy_exception(ex));
+  } catch (...) {
+    // Anything else is passed on as it is, as by the other asynchronous tasks
+    promise->set_exception(boost::current_exception());
+  }
+  finishAsyncTask();
+}
+
+template<class T>
+Executor::Ptr ClassLoader<T>::getExecutor()
+/***************************************************************************/
+{
+  boost::mutex::scoped_lock lock(async_mutex_);
+  if (!executor_) {
+    // Loads are serialized by library_mutex_, more threads would only wait
+    executor_.reset(new ThreadPoolExecutor(1));
+  }
+  return executor_;
+}
+
+template<class T>
+void ClassLoader<T>::startAsyncTask()
+/***************************************************************************/
+{
+  boost::mutex::scoped_lock lock(async_mutex_);
+  ++async_task_count_;
+}
+
+template<class T>
+void ClassLoader<T>::finishAsyncTask()
+/***************************************************************************/
+{
+  boost::mutex::scoped_lock lock(async_mutex_);
+  if (0 == --async_task_count_) {
+    async_condition_.notify_all();
+  }
+}
+
+template<class T>
+void ClassLoader<T>::processSingleXMLPluginFile(
+  const std::string & xml_file,
+  std::map<std::string, PluginManifest::ClassMap> & classes_available)
+/***************************************************************************/
+{
+  MappedFile file(xml_file);
+  if (!file.isOpen()) {
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Parsing xml file %s with tinyxml2.",
+      xml_file.c_str());
+    processSingleXMLPluginFileWithTinyXML(xml_file, classes_available);
+    return;
+  }
+  processSingleXMLPluginFile(xml_file, file.data(), file.size(), classes_available);
+}
+
+template<class T>
+void ClassLoader<T>::processSingleXMLPluginFile(
+  const std::string & xml_file, const char * data, size_t size,
+  std::map<std::string, PluginManifest::ClassMap> & classes_available)
+/***************************************************************************/
+{
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Processing xml file %s...", xml_file.c_str());
+  std::vector<PluginXMLClass> declarations;
+  if (!PluginXMLParser::parseClasses(data, size, declarations)) {
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Parsing xml file %s with tinyxml2.",
+      xml_file.c_str());
+    processSingleXMLPluginFileWithTinyXML(xml_file, classes_available);
+    return;
+  }
+
+  std::string package_name;
+  if (!declarations.empty()) {
+    package_name = getPackageFromPluginXMLFilePath(xml_file);
+    if ("" == package_name) {
+      ROS_ERROR_NAMED("pluginlib.ClassLoader",
+        "Could not find package manifest (neither package.xml or deprecated "
+        "manifest.xml) at same directory level as the plugin XML file %s. "
+        "Plugins will likely not be exported properly.\n)",
+        xml_file.c_str());
+    }
+  }
+
+  // Classes of every type are kept, for the loaders of the other base classes
+  for (size_t i = 0; i < declarations.size(); ++i) {
+    const PluginXMLClass & declaration = declarations[i];
+    std::string base_class_type(
+      declaration.base_class_type.data(), declaration.base_class_type.size());
+    std::string derived_class(declaration.type.data(), declaration.type.size());
+    std::string lookup_name = declaration.has_lookup_name ?
+      std::string(declaration.lookup_name.data(), declaration.lookup_name.size()) :
+      derived_class;
+    ClassDesc desc(lookup_name, derived_class, base_class_type, package_name,
+      declaration.has_description ? "" :
+      "No 'description' tag for this plugin in plugin description file.",
+      std::string(declaration.library_path.data(), declaration.library_path.size()), xml_file);
+    if (!declaration.description.empty()) {
+      // Few callers ever ask for a description, it is read from the file if one does
+      desc.deferDescription(declaration.description.data() - data,
+        declaration.description.size());
+    }
+    classes_available[base_class_type].insert(std::pair<std::string, ClassDesc>(lookup_name,
+      desc));
+  }
+}
+
+template<class T>
+void ClassLoader<T>::processSingleXMLPluginFileWithTinyXML(
+  const std::string & xml_file,
+  std::map<std::string, PluginManifest::ClassMap> & classes_available)
+/***************************************************************************/
+{
+  tinyxml2::XMLDocument document;
   document.LoadFile(xml_file.c_str());
   tinyxml2::XMLElement * config = document.RootElement();
   if (NULL == config) {
@@ -709,22 +1529,19 @@ void ClassLoader<T>::processSingleXMLPluginFile(
         lookup_name = derived_class;
       }
 
-      // make sure that this class is of the right type before registering it
-      if (base_class_type == base_class_) {
-        // register class here
-        tinyxml2::XMLElement * description = class_element->FirstChildElement("description");
-        std::string description_str;
-        if (description) {
-          description_str = description->GetText() ? description->GetText() : "";
-        } else {
-          description_str = "No 'description' tag for this plugin in plugin description file.";
-        }
-
-        classes_available.insert(std::pair<std::string, ClassDesc>(lookup_name,
-          ClassDesc(lookup_name, derived_class, base_class_type, package_name, description_str,
-          library_path, xml_file)));
+      // register class here, under its base class type
+      tinyxml2::XMLElement * description = class_element->FirstChildElement("description");
+      std::string description_str;
+      if (description) {
+        description_str = description->GetText() ? description->GetText() : "";
+      } else {
+        description_str = "No 'description' tag for this plugin in plugin description file.";
       }
 
+      classes_available[base_class_type].insert(std::pair<std::string, ClassDesc>(lookup_name,
+        ClassDesc(lookup_name, derived_class, base_class_type, package_name, description_str,
+        library_path, xml_file)));
+
       // step to next class_element
       class_element = class_element->NextSiblingElement("class");
     }
@@ -735,33 +1552,359 @@ void ClassLoader<T>::processSingleXMLPluginFile(
 template<class T>
 void ClassLoader<T>::refreshDeclaredClasses()
 /***************************************************************************/
+{
+  refreshDeclaredClassesIncremental();
+}
+
+template<class T>
+std::set<std::string> ClassLoader<T>::refreshDeclaredClassesIncremental()
+/***************************************************************************/
+{
+  ClassChanges changes;
+  refreshClasses(true, changes);
+
+  std::set<std::string> changed_classes(changes.added);
+  changed_classes.insert(changes.removed.begin(), changes.removed.end());
+  changed_classes.insert(changes.changed.begin(), changes.changed.end());
+  return changed_classes;
+}
+
+template<class T>
+void ClassLoader<T>::refreshClasses(bool recrawl, ClassChanges & changes)
+/***************************************************************************/
 {
   ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Refreshing declared classes.");
-  // determine classes not currently loaded for removal
-  std::list<std::string> remove_classes;
-  for (std::map<std::string, ClassDesc>::const_iterator it = classes_available_.begin();
-    it != classes_available_.end(); it++)
+  waitForDiscovery();
+  boost::mutex::scoped_lock refresh_lock(refresh_mutex_);
+  if (isFrozen()) {
+    throw pluginlib::ClassLoaderException(
+            "The classes of a frozen ClassLoader cannot be refreshed.");
+  }
+
+  std::vector<std::string> plugin_xml_paths;
+  PluginCatalog::ConstPtr previous_catalog;
+  DiscoveryRegistry::ClassMapPtr previous_classes;
+  {
+    boost::mutex::scoped_lock lock(classes_mutex_);
+    plugin_xml_paths = plugin_xml_paths_;
+    previous_catalog = catalog_;
+    previous_classes = classes_available_;
+  }
+
+  // Libraries may have been built, installed or removed since they were looked for
+  LibraryPathCache::instance().clear();
+  if (recrawl) {
+    // Packages may have appeared or moved since they were last looked for
+    PackageDirectoryCache::instance().clear();
+    plugin_xml_paths = getPluginXmlPaths(package_, attrib_name_, true, options_.backend);
+  }
+  PluginCatalog::ConstPtr catalog(new PluginCatalog(
+      determineAvailableManifests(plugin_xml_paths, previous_catalog->getManifests())));
+  if (catalog->hasSameManifests(*previous_catalog)) {
+    // Keep the classes, and the views into them handed out, if no manifest changed
+    catalog = previous_catalog;
+  }
+  DiscoveryRegistry::ClassMapPtr updated_classes = catalog->getClasses(base_class_);
+
+  boost::mutex::scoped_lock library_lock(library_mutex_);
+
+  // Classes whose library is loaded keep their description until it is unloaded
+  std::vector<std::string> open_libs = lowlevel_class_loader_.getRegisteredLibraries();
+  std::set<std::string> open_lib_set(open_libs.begin(), open_libs.end());
+  std::set<std::string> loaded_classes;
+  for (std::map<std::string, std::string>::const_iterator it = resolved_library_paths_.begin();
+    it != resolved_library_paths_.end(); ++it)
+  {
+    if (open_lib_set.count(it->second) > 0) {
+      loaded_classes.insert(it->first);
+    }
+  }
+
+  // Apply the difference between the current and the updated classes
+  std::vector<ClassDescRef> kept_classes;
+  for (size_t i = 0; i < previous_classes->size(); ++i) {
+    ClassDescRef previous = (*previous_classes)[i];
+    std::string lookup_name = previous.getLookupName();
+    ClassDescRef updated = updated_classes->find(lookup_name);
+    if (updated.isValid() && !isClassDescChanged(previous, updated)) {
+      continue;
+    }
+    if (loaded_classes.count(lookup_name) > 0) {
+      kept_classes.push_back(previous);
+      continue;
+    }
+    if (updated.isValid()) {
+      changes.changed.insert(lookup_name);
+    } else {
+      changes.removed.insert(lookup_name);
+    }
+    resolved_library_paths_.erase(lookup_name);
+  }
+  for (size_t i = 0; i < updated_classes->size(); ++i) {
+    const char * lookup_name = (*updated_classes)[i].getLookupName();
+    if (!previous_classes->find(lookup_name).isValid()) {
+      changes.added.insert(lookup_name);
+    }
+  }
+
+  DiscoveryRegistry::ClassMapPtr classes_available = previous_classes;
+  if (kept_classes.empty()) {
+    // Equal to the previous classes if nothing changed, but no longer holds on to their catalog
+    classes_available = updated_classes;
+  } else if (!changes.added.empty() || !changes.removed.empty() || !changes.changed.empty()) {
+    // Copy the kept descriptions and those of the catalog into a table of their own
+    std::vector<ClassDescRef> classes(kept_classes);
+    for (size_t i = 0; i < updated_classes->size(); ++i) {
+      classes.push_back((*updated_classes)[i]);
+    }
+    classes_available.reset(new ClassDescTable(classes));
+  }
+
+  {
+    boost::mutex::scoped_lock lock(classes_mutex_);
+    plugin_xml_paths_ = plugin_xml_paths;
+    catalog_ = catalog;
+    classes_available_ = classes_available;
+  }
+
+  // Let loaders created from now on start from the refreshed crawl
+  if (discovery_) {
+    boost::mutex::scoped_lock lock(discovery_->mutex);
+    discovery_->plugin_xml_paths = plugin_xml_paths;
+    discovery_->catalog = catalog;
+  }
+
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Refresh added %u, removed %u and changed %u classes.",
+    static_cast<unsigned int>(changes.added.size()),
+    static_cast<unsigned int>(changes.removed.size()),
+    static_cast<unsigned int>(changes.changed.size()));
+}
+
+template<class T>
+DiscoveryRegistry::ClassMapPtr ClassLoader<T>::getClassesAvailable() const
+/***************************************************************************/
+{
+  waitForDiscovery();
+  boost::mutex::scoped_lock lock(classes_mutex_);
+  return classes_available_;
+}
+
+template<class T>
+template<class Key>
+ClassDescRef ClassLoader<T>::findClass(
+  const Key & key, DiscoveryRegistry::ClassMapPtr & classes) const
+/***************************************************************************/
+{
+  waitForDiscovery();
+  FrozenClassTable::ConstPtr frozen_classes;
+  {
+    boost::mutex::scoped_lock lock(classes_mutex_);
+    classes = classes_available_;
+    frozen_classes = frozen_classes_;
+  }
+  if (frozen_classes) {
+    classes = frozen_classes->getClasses();
+    return frozen_classes->find(key);
+  }
+  return classes->find(key);
+}
+
+template<class T>
+void ClassLoader<T>::freeze()
+/***************************************************************************/
+{
+  waitForDiscovery();
+  // Before taking the refresh lock, which a refresh on the watcher's thread may hold
+  stopWatching();
+  boost::mutex::scoped_lock refresh_lock(refresh_mutex_);
+  if (isFrozen()) {
+    return;
+  }
+  FrozenClassTable::ConstPtr frozen_classes(new FrozenClassTable(getClassesAvailable()));
+  boost::mutex::scoped_lock lock(classes_mutex_);
+  frozen_classes_ = frozen_classes;
+  ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Froze %u classes, base = %s",
+    static_cast<unsigned int>(frozen_classes_->size()), base_class_.c_str());
+}
+
+template<class T>
+bool ClassLoader<T>::isFrozen() const
+/***************************************************************************/
+{
+  boost::mutex::scoped_lock lock(classes_mutex_);
+  return NULL != frozen_classes_.get();
+}
+
+template<class T>
+bool ClassLoader<T>::startWatching()
+/***************************************************************************/
+{
+  boost::shared_ptr<PluginWatcher> watcher;
+  {
+    boost::mutex::scoped_lock lock(classes_mutex_);
+    if (frozen_classes_) {
+      return false;
+    }
+    if (watcher_) {
+      return true;
+    }
+    watcher.reset(new PluginWatcher(
+        boost::bind(&ClassLoader<T>::onWatchedPathsChanged, this, _1)));
+    if (!watcher->isSupported()) {
+      return false;
+    }
+    watcher_ = watcher;
+  }
+  watcher->watch(getWatchedDirectories());
+  return true;
+}
+
+template<class T>
+void ClassLoader<T>::stopWatching()
+/***************************************************************************/
+{
+  boost::shared_ptr<PluginWatcher> watcher;
+  {
+    boost::mutex::scoped_lock lock(classes_mutex_);
+    watcher.swap(watcher_);
+  }
+  // Destroying the watcher joins its thread, which may be waiting for classes_mutex_
+  watcher.reset();
+}
+
+template<class T>
+bool ClassLoader<T>::isWatching() const
+/***************************************************************************/
+{
+  boost::mutex::scoped_lock lock(classes_mutex_);
+  return static_cast<bool>(watcher_);
+}
+
+template<class T>
+void ClassLoader<T>::addPluginEventCallback(const PluginEventCallback & callback)
+/***************************************************************************/
+{
+  boost::mutex::scoped_lock lock(classes_mutex_);
+  plugin_event_callbacks_.push_back(callback);
+}
+
+template<class T>
+std::set<std::string> ClassLoader<T>::getWatchedDirectories()
+/***************************************************************************/
+{
+  std::set<std::string> directories;
+  std::vector<std::string> plugin_xml_paths = getPluginXmlPaths();
+  for (std::vector<std::string>::const_iterator it = plugin_xml_paths.begin();
+    it != plugin_xml_paths.end(); ++it)
   {
-    std::string resolved_library_path = it->second.resolved_library_path_;
-    std::vector<std::string> open_libs = lowlevel_class_loader_.getRegisteredLibraries();
-    if (std::find(open_libs.begin(), open_libs.end(), resolved_library_path) != open_libs.end()) {
-      remove_classes.push_back(it->first);
+    directories.insert(boost::filesystem::path(*it).parent_path().string());
+    std::string package_directory;
+    PackageDirectoryCache::instance().getPackageFromPluginXMLFilePath(*it, &package_directory);
+    if (!package_directory.empty()) {
+      directories.insert(package_directory);
     }
   }
 
-  while (!remove_classes.empty()) {
-    classes_available_.erase(remove_classes.front());
-    remove_classes.pop_front();
+  // New packages show up in the share directory next to each catkin library directory
+  std::vector<std::string> lib_paths = getCatkinLibraryPaths();
+  for (std::vector<std::string>::const_iterator it = lib_paths.begin(); it != lib_paths.end();
+    ++it)
+  {
+    directories.insert(*it);
+    directories.insert((boost::filesystem::path(*it).parent_path() / "share").string());
   }
+  return directories;
+}
 
-  // add new classes
-  plugin_xml_paths_ = getPluginXmlPaths(package_, attrib_name_, true);
-  std::map<std::string, ClassDesc> updated_classes = determineAvailableClasses(plugin_xml_paths_);
-  for (std::map<std::string, ClassDesc>::const_iterator it = updated_classes.begin();
-    it != updated_classes.end(); it++)
+template<class T>
+void ClassLoader<T>::onWatchedPathsChanged(const std::set<std::string> & changed_paths)
+/***************************************************************************/
+{
+  // Events may still arrive while freeze() stops the watcher
+  if (isFrozen()) {
+    return;
+  }
+  std::set<std::string> lib_paths;
+  std::set<std::string> share_paths;
+  std::vector<std::string> catkin_lib_paths = getCatkinLibraryPaths();
+  for (std::vector<std::string>::const_iterator it = catkin_lib_paths.begin();
+    it != catkin_lib_paths.end(); ++it)
   {
-    if (classes_available_.find(it->first) == classes_available_.end()) {
-      classes_available_.insert(std::pair<std::string, ClassDesc>(it->first, it->second));
+    lib_paths.insert(*it);
+    share_paths.insert((boost::filesystem::path(*it).parent_path() / "share").string());
+  }
+
+  // Edited plugin manifests are picked up by their stamps without crawling. Only changes to
+  // package manifests, new packages and lost events require asking the crawler again.
+  bool recrawl = false;
+  std::set<std::string> changed_libraries;
+  for (std::set<std::string>::const_iterator it = changed_paths.begin();
+    it != changed_paths.end(); ++it)
+  {
+    boost::filesystem::path path(*it);
+    std::string file_name = path.filename().string();
+    std::string directory = path.parent_path().string();
+    if (it->empty() || "package.xml" == file_name || "manifest.xml" == file_name ||
+      share_paths.count(directory) > 0 || share_paths.count(*it) > 0)
+    {
+      recrawl = true;
+    } else if (lib_paths.count(directory) > 0) {
+      changed_libraries.insert(file_name);
+    }
+  }
+
+  ClassChanges changes;
+  refreshClasses(recrawl, changes);
+
+  // Report classes whose library was replaced as changed
+  if (!changed_libraries.empty()) {
+    DiscoveryRegistry::ClassMapPtr classes = getClassesAvailable();
+    for (size_t i = 0; i < classes->size(); ++i) {
+      ClassDescRef desc = (*classes)[i];
+      std::string library_file =
+        boost::filesystem::path(desc.getLibraryName()).filename().string();
+      for (std::set<std::string>::const_iterator lib_it = changed_libraries.begin();
+        lib_it != changed_libraries.end(); ++lib_it)
+      {
+        if (0 == lib_it->compare(0, library_file.size() + 1, library_file + ".") &&
+          0 == changes.added.count(desc.getLookupName()))
+        {
+          changes.changed.insert(desc.getLookupName());
+        }
+      }
+    }
+  }
+
+  // No reference to the watcher is taken here: stopWatching() must be the one to destroy it,
+  // which joins this thread
+  std::set<std::string> directories;
+  if (recrawl) {
+    directories = getWatchedDirectories();
+  }
+  std::vector<PluginEventCallback> callbacks;
+  {
+    boost::mutex::scoped_lock lock(classes_mutex_);
+    callbacks = plugin_event_callbacks_;
+    if (watcher_ && recrawl) {
+      watcher_->watch(directories);
+    }
+  }
+
+  for (size_t i = 0; i < callbacks.size(); ++i) {
+    for (std::set<std::string>::const_iterator it = changes.added.begin();
+      it != changes.added.end(); ++it)
+    {
+      callbacks[i](PLUGIN_ADDED, *it);
+    }
+    for (std::set<std::string>::const_iterator it = changes.removed.begin();
+      it != changes.removed.end(); ++it)
+    {
+      callbacks[i](PLUGIN_REMOVED, *it);
+    }
+    for (std::set<std::string>::const_iterator it = changes.changed.begin();
+      it != changes.changed.end(); ++it)
+    {
+      callbacks[i](PLUGIN_CHANGED, *it);
     }
   }
 }
@@ -770,34 +1913,38 @@ template<class T>
 std::string ClassLoader<T>::stripAllButFileFromPath(const std::string & path)
 /***************************************************************************/
 {
-  std::string only_file;
-  size_t c = path.find_last_of(getPathSeparator());
-  if (std::string::npos == c) {
-    return path;
-  } else {
-    return path.substr(c, path.size());
-  }
+  return LibraryPathResolver::stripAllButFileFromPath(path);
 }
 
 template<class T>
 int ClassLoader<T>::unloadLibraryForClass(const std::string & lookup_name)
 /***************************************************************************/
 {
-  ClassMapIterator it = classes_available_.find(lookup_name);
-  if (it != classes_available_.end() && it->second.resolved_library_path_ != "UNRESOLVED") {
-    std::string library_path = it->second.resolved_library_path_;
-    ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Attempting to unload library %s for class %s",
-      library_path.c_str(), lookup_name.c_str());
-    return unloadClassLibraryInternal(library_path);
-  } else {
-    throw pluginlib::LibraryUnloadException(getErrorStringForUnknownClass(lookup_name));
+  if (isClassAvailable(lookup_name)) {
+    boost::mutex::scoped_lock lock(library_mutex_);
+    std::map<std::string, std::string>::const_iterator it =
+      resolved_library_paths_.find(lookup_name);
+    if (it != resolved_library_paths_.end()) {
+      std::string library_path = it->second;
+      ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Attempting to unload library %s for class %s",
+        library_path.c_str(), lookup_name.c_str());
+      return unloadClassLibraryInternal(library_path);
+    }
   }
+  throw pluginlib::LibraryUnloadException(getErrorStringForUnknownClass(lookup_name));
 }
 
 template<class T>
 int ClassLoader<T>::unloadClassLibraryInternal(const std::string & library_path)
 /***************************************************************************/
 {
+  size_t handles = library_pins_->deferUnload(library_path);
+  if (0 != handles) {
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader",
+      "Unloading library %s once the %u plugin handles keeping it loaded are released.",
+      library_path.c_str(), static_cast<unsigned int>(handles));
+    return static_cast<int>(handles);
+  }
   return lowlevel_class_loader_.unloadLibrary(library_path);
 }
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__COMPILED_MANIFEST_HPP_
+#define PLUGINLIB__COMPILED_MANIFEST_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "boost/thread/mutex.hpp"
+
+// Tables generated by pluginlib_compile_manifests() are constant initialized either way.
+#if __cplusplus >= 201103L
+#define PLUGINLIB_COMPILED_MANIFEST_CONST constexpr
+#else
+#define PLUGINLIB_COMPILED_MANIFEST_CONST const
+#endif
+
+namespace pluginlib
+{
+
+/// A class declared by a plugin description file, as compiled into a generated table.
+struct CompiledClass
+{
+  const char * lookup_name;
+  const char * type;
+  const char * base_class_type;
+  const char * library_path;
+  const char * description;
+};
+
+/// A plugin description file compiled at build time by pluginlib_compile_manifests().
+struct CompiledManifest
+{
+  /// The package exporting the file.
+  const char * package;
+  /// The path of the file relative to the package directory, e.g. "plugins.xml".
+  const char * relative_path;
+  const CompiledClass * classes;
+  size_t class_count;
+};
+
+/// Process-wide registry of the plugin description files compiled into the running binaries.
+/**
+ * A ClassLoader takes the classes of a plugin description file from here instead of reading and
+ * parsing it, so only the crawl for the files' paths touches the filesystem. The tables reflect
+ * the files at build time; rebuild after editing a compiled file.
+ */
+class CompiledManifestRegistry
+{
+public:
+  /// Return the registry of this process.
+  static CompiledManifestRegistry & instance()
+  {
+    static CompiledManifestRegistry registry;
+    return registry;
+  }
+
+  void add(const CompiledManifest * manifest)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    manifests_.push_back(manifest);
+  }
+
+  void remove(const CompiledManifest * manifest)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    for (size_t i = 0; i < manifests_.size(); ++i) {
+      if (manifests_[i] == manifest) {
+        manifests_.erase(manifests_.begin() + i);
+        return;
+      }
+    }
+  }
+
+  /// Return the compiled table for a plugin description file, or NULL if there is none.
+  /**
+   * A table matches a path that ends with "<package>/<relative_path>", which holds for the
+   * source, devel and install spaces as long as the package directory is named after the
+   * package. Files in other locations are simply parsed at runtime.
+   */
+  const CompiledManifest * find(const std::string & plugin_xml_path) const
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    for (size_t i = 0; i < manifests_.size(); ++i) {
+      const CompiledManifest & manifest = *manifests_[i];
+      size_t package_length = std::strlen(manifest.package);
+      size_t relative_length = std::strlen(manifest.relative_path);
+      size_t suffix_length = package_length + 1 + relative_length;
+      if (plugin_xml_path.size() < suffix_length) {
+        continue;
+      }
+      size_t start = plugin_xml_path.size() - suffix_length;
+      if ((0 == start || '/' == plugin_xml_path[start - 1]) &&
+        0 == plugin_xml_path.compare(start, package_length, manifest.package) &&
+        '/' == plugin_xml_path[start + package_length] &&
+        0 == plugin_xml_path.compare(start + package_length + 1, relative_length,
+        manifest.relative_path))
+      {
+        return &manifest;
+      }
+    }
+    return NULL;
+  }
+
+private:
+  CompiledManifestRegistry() {}
+  CompiledManifestRegistry(const CompiledManifestRegistry &);
+  CompiledManifestRegistry & operator=(const CompiledManifestRegistry &);
+
+  mutable boost::mutex mutex_;
+  std::vector<const CompiledManifest *> manifests_;
+};
+
+/// Registers a compiled table for as long as the binary holding it is loaded.
+class CompiledManifestRegistrar
+{
+public:
+  explicit CompiledManifestRegistrar(const CompiledManifest & manifest)
+  : manifest_(manifest)
+  {
+    CompiledManifestRegistry::instance().add(&manifest_);
+  }
+
+  ~CompiledManifestRegistrar()
+  {
+    CompiledManifestRegistry::instance().remove(&manifest_);
+  }
+
+private:
+  const CompiledManifest & manifest_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__COMPILED_MANIFEST_HPP_
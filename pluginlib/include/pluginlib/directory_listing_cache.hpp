@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__DIRECTORY_LISTING_CACHE_HPP_
+#define PLUGINLIB__DIRECTORY_LISTING_CACHE_HPP_
+
+#include <ctime>
+#include <map>
+#include <string>
+
+#include "boost/cstdint.hpp"
+#include "boost/filesystem.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/unordered_set.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pluginlib
+{
+
+/// Process-wide listings of directories, to tell whether files exist without probing each one.
+/**
+ * Resolving a library checks several candidate paths in every library directory of the
+ * workspace overlays, most of which do not exist. On Linux, this cache reads each directory once
+ * with getdents64 and answers from the set of names it holds, so that a miss costs no system
+ * call. After invalidate(), each directory is checked once more with a stat, and read again
+ * only if its modification time changed. Listings not asked about since the invalidate() before
+ * are dropped, so that directories which no longer matter, e.g. those of a previous
+ * CMAKE_PREFIX_PATH, are not kept forever. Elsewhere the cache asks the filesystem about every
+ * path.
+ */
+class DirectoryListingCache
+{
+public:
+  /// Return the cache of this process.
+  static DirectoryListingCache & instance()
+  {
+    static DirectoryListingCache cache;
+    return cache;
+  }
+
+  /// Return whether a path exists, like boost::filesystem::exists().
+  /**
+   * Files added to or removed from a directory listed since the last invalidate() may go
+   * unnoticed, unless the directory was modified within the last second or so.
+   */
+  bool exists(const std::string & path)
+  {
+#ifdef __linux__
+    size_t separator = path.rfind('/');
+    if (std::string::npos == separator || separator + 1 == path.size()) {
+      return boost::filesystem::exists(path);
+    }
+    std::string name = path.substr(separator + 1);
+    if ("." == name || ".." == name) {
+      return boost::filesystem::exists(path);
+    }
+
+    boost::shared_ptr<Directory> directory;
+    std::string directory_path = 0 == separator ? "/" : path.substr(0, separator);
+    boost::uint64_t generation;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      generation = generation_;
+      Entry & entry = directories_[directory_path];
+      if (!entry.directory) {
+        entry.directory.reset(new Directory());
+      }
+      entry.requested = generation;
+      directory = entry.directory;
+    }
+    {
+      boost::mutex::scoped_lock lock(directory->mutex);
+      bool current = directory->listed && generation == directory->generation;
+      if (!current) {
+        current = update(directory_path, *directory);
+        directory->generation = generation;
+      }
+      if (current && 0 == directory->names.count(name)) {
+        return false;
+      }
+    }
+    // A listed name may be a dangling symbolic link, which does not exist
+#endif
+    return boost::filesystem::exists(path);
+  }
+
+  /// Check every directory for changes when it is next asked about.
+  void invalidate()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    for (DirectoryMap::iterator it = directories_.begin(); it != directories_.end(); ) {
+      if (it->second.requested != generation_) {
+        directories_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    ++generation_;
+  }
+
+  /// Return the number of directories whose listings are kept.
+  size_t getDirectoryCount() const
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return directories_.size();
+  }
+
+private:
+  struct Directory
+  {
+    Directory()
+    : listed(false), generation(0), inode(0), modified_seconds(0), modified_nanoseconds(0) {}
+
+    // Guards the members below; held while the directory is listed.
+    boost::mutex mutex;
+    // Whether names holds the listing as of the times below, to be reused while they match.
+    bool listed;
+    // The generation_ of the cache when the times were last checked.
+    boost::uint64_t generation;
+    boost::uint64_t inode;
+    boost::int64_t modified_seconds;
+    boost::int64_t modified_nanoseconds;
+    boost::unordered_set<std::string> names;
+  };
+
+  struct Entry
+  {
+    Entry()
+    : requested(0) {}
+
+    boost::shared_ptr<Directory> directory;
+    // The generation_ of the cache when the directory was last asked about.
+    boost::uint64_t requested;
+  };
+
+  typedef std::map<std::string, Entry> DirectoryMap;
+
+  DirectoryListingCache()
+  : generation_(0) {}
+  DirectoryListingCache(const DirectoryListingCache &);
+  DirectoryListingCache & operator=(const DirectoryListingCache &);
+
+#ifdef __linux__
+  /// The layout of the records getdents64 fills its buffer with.
+  struct LinuxDirent64
+  {
+    boost::uint64_t d_ino;
+    boost::int64_t d_off;
+    unsigned short d_reclen;  // NOLINT
+    unsigned char d_type;
+    char d_name[1];
+  };
+
+  /// Read the directory again if it changed since it was listed.
+  /**
+   * \return Whether the names are the current ones, false if the directory cannot be read
+   */
+  static bool update(const std::string & path, Directory & directory)
+  {
+    struct stat status;
+    if (0 != ::stat(path.c_str(), &status) || !S_ISDIR(status.st_mode)) {
+      // Nothing exists in a missing directory
+      directory.listed = true;
+      directory.inode = 0;
+      directory.names.clear();
+      return true;
+    }
+    if (directory.listed && static_cast<boost::uint64_t>(status.st_ino) == directory.inode &&
+      status.st_mtim.tv_sec == directory.modified_seconds &&
+      status.st_mtim.tv_nsec == directory.modified_nanoseconds)
+    {
+      return true;
+    }
+
+    // Stat before listing, so that changes made meanwhile show as a later modification time
+    directory.names.clear();
+    if (!list(path, directory.names)) {
+      directory.listed = false;
+      return false;
+    }
+    directory.inode = status.st_ino;
+    directory.modified_seconds = status.st_mtim.tv_sec;
+    directory.modified_nanoseconds = status.st_mtim.tv_nsec;
+    // On filesystems with coarse timestamps, a change within the same tick would go unnoticed,
+    // so a listing of a directory modified that recently is read again next time
+    directory.listed = status.st_mtim.tv_sec + 1 < std::time(NULL);
+    return true;
+  }
+
+  /// Add the names of the entries of a directory, returning false if it cannot be read.
+  static bool list(const std::string & path, boost::unordered_set<std::string> & names)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    // Aligned for the 64-bit fields of the records
+    boost::uint64_t buffer[4096];
+    long size;  // NOLINT
+    while ((size = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer))) > 0) {
+      const char * records = reinterpret_cast<const char *>(buffer);
+      for (long offset = 0; offset < size; ) {  // NOLINT
+        const LinuxDirent64 * entry = reinterpret_cast<const LinuxDirent64 *>(records + offset);
+        names.insert(entry->d_name);
+        offset += entry->d_reclen;
+      }
+    }
+    ::close(fd);
+    return 0 == size;
+  }
+#endif
+
+  mutable boost::mutex mutex_;
+  // Incremented by invalidate().
+  boost::uint64_t generation_;
+  DirectoryMap directories_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__DIRECTORY_LISTING_CACHE_HPP_
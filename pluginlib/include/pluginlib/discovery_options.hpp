@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__DISCOVERY_OPTIONS_HPP_
+#define PLUGINLIB__DISCOVERY_OPTIONS_HPP_
+
+#include <cstdlib>
+#include <cstring>
+
+namespace pluginlib
+{
+
+/// Where a ClassLoader looks for the plugin XML files exported by packages.
+enum DiscoveryBackend
+{
+  /// Ask rospack, through ros::package::getPlugins().
+  DISCOVERY_BACKEND_ROSPACK,
+  /// Crawl ROS_PACKAGE_PATH and CMAKE_PREFIX_PATH with the built-in PackageCrawler.
+  DISCOVERY_BACKEND_NATIVE
+};
+
+/// Return the backend used when none is requested explicitly.
+/**
+ * This is rospack, unless the PLUGINLIB_DISCOVERY_BACKEND environment variable is set to
+ * "native".
+ */
+inline DiscoveryBackend getDefaultDiscoveryBackend()
+{
+  const char * env = std::getenv("PLUGINLIB_DISCOVERY_BACKEND");
+  if (env && 0 == std::strcmp(env, "native")) {
+    return DISCOVERY_BACKEND_NATIVE;
+  }
+  return DISCOVERY_BACKEND_ROSPACK;
+}
+
+/// Return whether discovery batches its file system calls unless told otherwise.
+/**
+ * This is off, unless the PLUGINLIB_BATCHED_IO environment variable is set to "1".
+ */
+inline bool getDefaultBatchedIO()
+{
+  const char * env = std::getenv("PLUGINLIB_BATCHED_IO");
+  return env && 0 == std::strcmp(env, "1");
+}
+
+/// Return whether loaders prefetch their libraries unless told otherwise.
+/**
+ * This is off, unless the PLUGINLIB_PREFETCH_LIBRARIES environment variable is set to "1".
+ */
+inline bool getDefaultPrefetchLibraries()
+{
+  const char * env = std::getenv("PLUGINLIB_PREFETCH_LIBRARIES");
+  return env && 0 == std::strcmp(env, "1");
+}
+
+/// How a ClassLoader discovers the available plugins.
+struct DiscoveryOptions
+{
+  DiscoveryOptions()
+  : backend(getDefaultDiscoveryBackend()), deferred(false), batched_io(getDefaultBatchedIO()),
+    prefetch_libraries(getDefaultPrefetchLibraries()) {}
+
+  DiscoveryBackend backend;
+  /// Whether the constructor returns right away and discovery runs on a background thread.
+  /**
+   * The methods that need the discovery results wait for it to complete. ClassLoader::ready()
+   * returns a future to wait for or poll explicitly.
+   */
+  bool deferred;
+  /// Whether the plugin manifests are stamped and read in batches through io_uring.
+  /**
+   * Saves a system call per file and operation where those are slow, such as on overlayfs.
+   * Ignored where io_uring is not available, see BatchedFileIO.
+   */
+  bool batched_io;
+  /// Whether the constructor starts ClassLoader::prefetchLibraries() once discovery completes.
+  bool prefetch_libraries;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__DISCOVERY_OPTIONS_HPP_
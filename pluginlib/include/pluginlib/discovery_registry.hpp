@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__DISCOVERY_REGISTRY_HPP_
+#define PLUGINLIB__DISCOVERY_REGISTRY_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/weak_ptr.hpp"
+#include "pluginlib/discovery_options.hpp"
+#include "pluginlib/plugin_catalog.hpp"
+
+namespace pluginlib
+{
+
+/// Process-wide store of plugin discovery results shared between ClassLoader instances.
+/**
+ * Discovery (crawling for plugin.xml files and parsing them) only depends on the package,
+ * attribute name and discovery backend a ClassLoader was constructed with. Loaders with the same
+ * (package, attrib_name, backend) therefore share one Entry: the first loader crawls and builds
+ * the PluginCatalog for all base classes, every later loader takes its view of it.
+ *
+ * Entries are reference counted by the loaders holding them and released together with the
+ * last loader.
+ */
+class DiscoveryRegistry
+{
+public:
+  typedef PluginCatalog::ClassMap ClassMap;
+  typedef PluginCatalog::ClassMapPtr ClassMapPtr;
+
+  /// Discovery results for one (package, attrib_name, backend) triple.
+  /**
+   * The members may only be accessed while holding mutex, which is never held while crawling or
+   * parsing. Loaders that need to crawl or parse take work_mutex first, so that one of them does
+   * the work and the others find its result. Catalogs are never modified once published, a
+   * refresh replaces them instead.
+   */
+  struct Entry
+  {
+    Entry()
+    : crawled(false) {}
+
+    boost::mutex mutex;
+    boost::mutex work_mutex;
+    // Whether plugin_xml_paths holds the result of a crawl.
+    bool crawled;
+    std::vector<std::string> plugin_xml_paths;
+    // The classes the manifests in plugin_xml_paths declare, or NULL until they are parsed.
+    PluginCatalog::ConstPtr catalog;
+  };
+
+  typedef boost::shared_ptr<Entry> EntryPtr;
+
+  /// Return the registry of this process.
+  static DiscoveryRegistry & instance()
+  {
+    static DiscoveryRegistry registry;
+    return registry;
+  }
+
+  /// Return the entry for a package, attribute name and backend, creating it if necessary.
+  EntryPtr acquire(
+    const std::string & package, const std::string & attrib_name, DiscoveryBackend backend)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    // Drop the entries all loaders let go of.
+    for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ) {
+      if (it->second.expired()) {
+        entries_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+
+    boost::weak_ptr<Entry> & weak_entry =
+      entries_[Key(backend, std::make_pair(package, attrib_name))];
+    EntryPtr entry = weak_entry.lock();
+    if (!entry) {
+      entry.reset(new Entry());
+      weak_entry = entry;
+    }
+    return entry;
+  }
+
+private:
+  typedef std::pair<DiscoveryBackend, std::pair<std::string, std::string> > Key;
+  typedef std::map<Key, boost::weak_ptr<Entry> > EntryMap;
+
+  DiscoveryRegistry() {}
+  DiscoveryRegistry(const DiscoveryRegistry &);
+  DiscoveryRegistry & operator=(const DiscoveryRegistry &);
+
+  boost::mutex mutex_;
+  EntryMap entries_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__DISCOVERY_REGISTRY_HPP_
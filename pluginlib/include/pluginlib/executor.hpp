@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__EXECUTOR_HPP_
+#define PLUGINLIB__EXECUTOR_HPP_
+
+#include <deque>
+
+#include "boost/bind.hpp"
+#include "boost/function.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+namespace pluginlib
+{
+
+/// Runs tasks, such as the asynchronous loads of a ClassLoader, on some thread.
+/**
+ * Implement it to run them on the threads of an application's own event loop or pool.
+ */
+class Executor
+{
+public:
+  typedef boost::shared_ptr<Executor> Ptr;
+
+  virtual ~Executor() {}
+
+  /// Run task eventually; task does not throw.
+  virtual void post(const boost::function<void()> & task) = 0;
+};
+
+/// Runs tasks in the order posted on threads of its own.
+class ThreadPoolExecutor : public Executor
+{
+public:
+  /**
+   * \param thread_count The number of threads, started when the first task is posted
+   */
+  explicit ThreadPoolExecutor(size_t thread_count = 1)
+  : thread_count_(thread_count > 1 ? thread_count : 1), idle_count_(0), stopping_(false) {}
+
+  /// Run the tasks posted so far, then join the threads.
+  ~ThreadPoolExecutor()
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      stopping_ = true;
+    }
+    condition_.notify_all();
+    threads_.join_all();
+  }
+
+  void post(const boost::function<void()> & task)
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      tasks_.push_back(task);
+      // A thread more only if the idle ones do not pick up every queued task
+      if (tasks_.size() > idle_count_ && threads_.size() < thread_count_) {
+        threads_.create_thread(boost::bind(&ThreadPoolExecutor::run, this));
+      }
+    }
+    condition_.notify_one();
+  }
+
+private:
+  ThreadPoolExecutor(const ThreadPoolExecutor &);
+  ThreadPoolExecutor & operator=(const ThreadPoolExecutor &);
+
+  void run()
+  {
+    for (;; ) {
+      boost::function<void()> task;
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        while (tasks_.empty() && !stopping_) {
+          ++idle_count_;
+          condition_.wait(lock);
+          --idle_count_;
+        }
+        if (tasks_.empty()) {
+          return;
+        }
+        task.swap(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  size_t thread_count_;
+  size_t idle_count_;
+  bool stopping_;
+  std::deque<boost::function<void()> > tasks_;
+  boost::mutex mutex_;
+  boost::condition_variable condition_;
+  boost::thread_group threads_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__EXECUTOR_HPP_
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__FROZEN_CLASS_TABLE_HPP_
+#define PLUGINLIB__FROZEN_CLASS_TABLE_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/cstdint.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/utility/string_view.hpp"
+#include "pluginlib/class_desc_store.hpp"
+#include "pluginlib/lookup_key.hpp"
+
+namespace pluginlib
+{
+
+/// Immutable lookup table from lookup names to class descriptions, using a minimal perfect hash.
+/**
+ * Built once by ClassLoader::freeze() with the "hash, displace and compress" scheme: the names
+ * are hashed into buckets of about four, and each bucket gets a displacement that sends its
+ * names to slots no other name occupies. A lookup hashes the name once, reads one displacement
+ * and one 16-byte slot, and compares the name only if the stored hash matches, so at most one
+ * string comparison is made. The table has exactly one slot per class. Names hash as by
+ * hashLookupName(), so that a LookupKey hashed at compile time needs no hashing at all.
+ */
+class FrozenClassTable
+{
+public:
+  typedef ClassDescTable ClassMap;
+  typedef ClassDescTable::ConstPtr ClassMapPtr;
+  typedef boost::shared_ptr<const FrozenClassTable> ConstPtr;
+
+  /// Index the classes, which the table keeps alive.
+  explicit FrozenClassTable(const ClassMapPtr & classes)
+  : classes_(classes), seed_(0)
+  {
+    std::vector<boost::uint64_t> hashes;
+    if (!hashNames(hashes)) {
+      return;
+    }
+    while (!build(hashes)) {
+      ++seed_;
+    }
+  }
+
+  /// Return the description of a class, or an invalid reference if there is none by the name.
+  ClassDescRef find(boost::string_view lookup_name) const
+  {
+    return find(LookupKey(lookup_name));
+  }
+
+  /// Return the description of a class, or an invalid reference if there is none by the name.
+  /**
+   * The key's hash is used as is, so only a found name is compared.
+   */
+  ClassDescRef find(const LookupKey & key) const
+  {
+    if (slots_.empty()) {
+      return classes_->find(key.getName());
+    }
+    boost::uint64_t hash = seedHash(key.getHash());
+    const Slot & slot = slots_[getSlot(hash, displacements_[getBucket(hash)])];
+    if (slot.hash == key.getHash()) {
+      ClassDescRef desc = (*classes_)[slot.index];
+      if (key.getName() == desc.getLookupName()) {
+        return desc;
+      }
+    }
+    return ClassDescRef();
+  }
+
+  /// Return the number of classes in the table.
+  size_t size() const
+  {
+    return slots_.size();
+  }
+
+  /// Return the classes the table was built from.
+  const ClassMapPtr & getClasses() const
+  {
+    return classes_;
+  }
+
+private:
+  struct Slot
+  {
+    // Hash of the name as by hashLookupName(), before seedHash().
+    boost::uint64_t hash;
+    // Position of the class in classes_.
+    boost::uint32_t index;
+  };
+
+  // Average number of names per bucket; larger buckets make the table smaller but slower to build.
+  static const size_t kBucketSize = 4;
+
+  /// Hash the names, returning false if there are none or two share a hash no seed can separate.
+  bool hashNames(std::vector<boost::uint64_t> & hashes) const
+  {
+    hashes.resize(classes_->size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+      const char * lookup_name = (*classes_)[i].getLookupName();
+      hashes[i] = hashLookupNameAtRuntime(lookup_name, std::strlen(lookup_name));
+    }
+    // Practically never, in which case find() falls back to searching classes_
+    std::vector<boost::uint64_t> sorted(hashes);
+    std::sort(sorted.begin(), sorted.end());
+    return !sorted.empty() && std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+  }
+
+  /// Rehash with the seed, unless it is zero, so that keys hashed ahead of time remain valid.
+  boost::uint64_t seedHash(boost::uint64_t hash) const
+  {
+    return 0 == seed_ ? hash : detail::mixHash(hash + seed_ * 0x9e3779b97f4a7c15ULL);
+  }
+
+  /// Map 32 bits of a hash onto [0, count) by multiplication, which is cheaper than a division.
+  static size_t reduce(boost::uint64_t bits, size_t count)
+  {
+    return static_cast<size_t>(((bits & 0xffffffffULL) * count) >> 32);
+  }
+
+  size_t getBucket(boost::uint64_t hash) const
+  {
+    return reduce(hash >> 32, displacements_.size());
+  }
+
+  size_t getSlot(boost::uint64_t hash, boost::uint32_t displacement) const
+  {
+    return reduce(detail::mixHash(hash + (displacement + 1ULL) * 0x9e3779b97f4a7c15ULL),
+             slots_.size());
+  }
+
+  /// Place every class with the current seed, returning false if two names hash alike.
+  bool build(const std::vector<boost::uint64_t> & hashes)
+  {
+    size_t count = classes_->size();
+    size_t bucket_count = std::max<size_t>(1, count / kBucketSize);
+    std::vector<std::vector<Slot> > buckets(bucket_count);
+    std::vector<std::vector<boost::uint64_t> > seeded_hashes(bucket_count);
+    for (size_t i = 0; i < count; ++i) {
+      Slot slot;
+      slot.hash = hashes[i];
+      slot.index = static_cast<boost::uint32_t>(i);
+      boost::uint64_t seeded_hash = seedHash(slot.hash);
+      size_t bucket = reduce(seeded_hash >> 32, bucket_count);
+      buckets[bucket].push_back(slot);
+      seeded_hashes[bucket].push_back(seeded_hash);
+    }
+
+    // Place the largest buckets first, while most slots are free
+    std::vector<std::pair<size_t, size_t> > order;
+    for (size_t i = 0; i < bucket_count; ++i) {
+      for (size_t j = 0; j < buckets[i].size(); ++j) {
+        for (size_t k = j + 1; k < buckets[i].size(); ++k) {
+          if (seeded_hashes[i][j] == seeded_hashes[i][k]) {
+            return false;
+          }
+        }
+      }
+      order.push_back(std::make_pair(buckets[i].size(), i));
+    }
+    std::sort(order.rbegin(), order.rend());
+
+    slots_.assign(count, Slot());
+    displacements_.assign(bucket_count, 0);
+    std::vector<bool> occupied(count, false);
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < order.size() && order[i].first > 0; ++i) {
+      const std::vector<Slot> & bucket = buckets[order[i].second];
+      for (boost::uint32_t displacement = 0; ; ++displacement) {
+        positions.clear();
+        for (size_t j = 0; j < bucket.size(); ++j) {
+          size_t position = getSlot(seeded_hashes[order[i].second][j], displacement);
+          if (occupied[position] ||
+            std::find(positions.begin(), positions.end(), position) != positions.end())
+          {
+            break;
+          }
+          positions.push_back(position);
+        }
+        if (positions.size() == bucket.size()) {
+          displacements_[order[i].second] = displacement;
+          break;
+        }
+      }
+      for (size_t j = 0; j < bucket.size(); ++j) {
+        occupied[positions[j]] = true;
+        slots_[positions[j]] = bucket[j];
+      }
+    }
+    return true;
+  }
+
+  ClassMapPtr classes_;
+  boost::uint32_t seed_;
+  std::vector<boost::uint32_t> displacements_;
+  std::vector<Slot> slots_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__FROZEN_CLASS_TABLE_HPP_
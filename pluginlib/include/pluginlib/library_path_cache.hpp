@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__LIBRARY_PATH_CACHE_HPP_
+#define PLUGINLIB__LIBRARY_PATH_CACHE_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "boost/cstdint.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "pluginlib/directory_listing_cache.hpp"
+#include "pluginlib/resolution_context.hpp"
+#include "ros/console.h"
+
+namespace pluginlib
+{
+
+/// Process-wide memo of where the library a plugin description names was found, if anywhere.
+/**
+ * Resolving a library means asking rospack for the exporting package's path and checking up to
+ * four candidate paths per library directory for existence. This cache remembers the result per
+ * library name and package, including the libraries that were not found, so that loading and
+ * unloading a library repeatedly, or asking for a missing one, does not touch the filesystem
+ * again. ClassLoader clears it whenever the classes are refreshed. The results are tied to a
+ * ResolutionContext, and forgotten when that is invalidated.
+ */
+class LibraryPathCache
+{
+public:
+  /// Return the cache of this process.
+  static LibraryPathCache & instance()
+  {
+    static LibraryPathCache cache;
+    return cache;
+  }
+
+  /// Return the path of a library as by LibraryPathResolver::resolve(), resolving it only once.
+  /**
+   * \param library_name The library as named in the plugin description
+   * \param package The package exporting the plugin
+   * \return The path to the library, or an empty string if it cannot be found
+   */
+  std::string resolve(const std::string & library_name, const std::string & package)
+  {
+    ResolutionContext::ConstPtr context = ResolutionContext::getCurrent();
+    boost::shared_ptr<Library> library;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      if (context->getGeneration() > generation_) {
+        libraries_.clear();
+        generation_ = context->getGeneration();
+      }
+      if (context->getGeneration() == generation_) {
+        boost::shared_ptr<Library> & entry = libraries_[std::make_pair(library_name, package)];
+        if (!entry) {
+          entry.reset(new Library());
+        }
+        library = entry;
+      } else {
+        // Taken before a newer context replaced it, so not worth remembering
+        library.reset(new Library());
+      }
+    }
+
+    // Resolve outside of the cache lock, like PackageDirectoryCache::probe(). An entry dropped
+    // by clear() meanwhile is resolved for the callers holding it only.
+    boost::mutex::scoped_lock lock(library->mutex);
+    if (!library->resolved) {
+      library->path = context->resolve(library_name, package);
+      library->resolved = true;
+    } else {
+      ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Library %s of package %s was resolved to '%s'.",
+        library_name.c_str(), package.c_str(), library->path.c_str());
+    }
+    return library->path;
+  }
+
+  /// Forget everything, e.g. because libraries may have been built, installed or removed.
+  /**
+   * The environment and the library directories are checked for changes again too, see
+   * ResolutionContext and DirectoryListingCache.
+   */
+  void clear()
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      libraries_.clear();
+    }
+    ResolutionContext::invalidate();
+    DirectoryListingCache::instance().invalidate();
+  }
+
+private:
+  struct Library
+  {
+    Library()
+    : resolved(false) {}
+
+    // Guards the members below; held while the library is resolved.
+    boost::mutex mutex;
+    bool resolved;
+    // Empty if the library was not found.
+    std::string path;
+  };
+
+  LibraryPathCache()
+  : generation_(0) {}
+  LibraryPathCache(const LibraryPathCache &);
+  LibraryPathCache & operator=(const LibraryPathCache &);
+
+  boost::mutex mutex_;
+  // The generation of the ResolutionContext the libraries were resolved in.
+  boost::uint64_t generation_;
+  std::map<std::pair<std::string, std::string>, boost::shared_ptr<Library> > libraries_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__LIBRARY_PATH_CACHE_HPP_
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__LIBRARY_PATH_RESOLVER_HPP_
+#define PLUGINLIB__LIBRARY_PATH_RESOLVER_HPP_
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "boost/filesystem.hpp"
+#include "class_loader/class_loader.hpp"
+#include "pluginlib/directory_listing_cache.hpp"
+#include "ros/console.h"
+
+namespace pluginlib
+{
+
+/// Finds the shared library a plugin description refers to, e.g. "lib/libfoo".
+/**
+ * Shared by ClassLoader and the pluginlib_index tool, so that an index records the very paths
+ * a ClassLoader would load.
+ */
+class LibraryPathResolver
+{
+public:
+  /// Return the paths where libraries are installed according to the Catkin build system.
+  static std::vector<std::string> getCatkinLibraryPaths()
+  {
+#ifdef _WIN32
+    const char * separator = ";";
+#else
+    const char * separator = ":";
+#endif
+    std::vector<std::string> lib_paths;
+    const char * env = std::getenv("CMAKE_PREFIX_PATH");
+    if (env) {
+      std::string env_catkin_prefix_paths(env);
+      std::vector<std::string> catkin_prefix_paths;
+      boost::split(catkin_prefix_paths, env_catkin_prefix_paths, boost::is_any_of(separator));
+      for (size_t i = 0; i < catkin_prefix_paths.size(); ++i) {
+        boost::filesystem::path path(catkin_prefix_paths[i]);
+        boost::filesystem::path lib("lib");
+        lib_paths.push_back((path / lib).string());
+      }
+    }
+    return lib_paths;
+  }
+
+  /// Get the standard path separator for the native OS (e.g. "/" on *nix, "\" on Windows).
+  static std::string getPathSeparator()
+  {
+#if BOOST_FILESYSTEM_VERSION >= 3
+    return boost::filesystem::path("/").native();
+#else
+    return boost::filesystem::path("/").external_file_string();
+#endif
+  }
+
+  /// Strip all but the filename from an explicit file path.
+  static std::string stripAllButFileFromPath(const std::string & path)
+  {
+    size_t c = path.find_last_of(getPathSeparator());
+    if (std::string::npos == c) {
+      return path;
+    } else {
+      return path.substr(c, path.size());
+    }
+  }
+
+  /// Get a list of paths to try to find a library.
+  /**
+   * As we transition from rosbuild to Catkin build systems, plugins can be
+   * found in the old rosbuild place (pkg_name/lib usually) or somewhere in the
+   * Catkin build space.
+   *
+   * \param library_name The library as named in the plugin description
+   * \param rosbuild_library_path The directory of the exporting package
+   */
+  static std::vector<std::string> getAllLibraryPathsToTry(
+    const std::string & library_name,
+    const std::string & rosbuild_library_path)
+  {
+    return getAllLibraryPathsToTry(library_name, rosbuild_library_path, getCatkinLibraryPaths());
+  }
+
+  /// Like getAllLibraryPathsToTry(), with the result of getCatkinLibraryPaths() given.
+  static std::vector<std::string> getAllLibraryPathsToTry(
+    const std::string & library_name,
+    const std::string & rosbuild_library_path,
+    const std::vector<std::string> & catkin_library_paths)
+  {
+    // Catkin-rosbuild Backwards Compatability Rules - Note library_name may be prefixed with
+    // relative path (e.g. "/lib/libFoo")
+    // 1. Try catkin library paths (catkin_find --libs) + library_name + extension
+    // 2. Try catkin library paths
+    //   (catkin_find -- libs) + stripAllButFileFromPath(library_name) + extension
+    // 3. Try export_pkg/library_name + extension
+
+    std::vector<std::string> all_paths;
+    std::vector<std::string> all_paths_without_extension = catkin_library_paths;
+    all_paths_without_extension.push_back(rosbuild_library_path);
+    bool debug_library_suffix = (0 == class_loader::systemLibrarySuffix().compare(0, 1, "d"));
+    std::string non_debug_suffix;
+    if (debug_library_suffix) {
+      non_debug_suffix = class_loader::systemLibrarySuffix().substr(1);
+    } else {
+      non_debug_suffix = class_loader::systemLibrarySuffix();
+    }
+    std::string library_name_with_extension = library_name + non_debug_suffix;
+    std::string stripped_library_name = stripAllButFileFromPath(library_name);
+    std::string stripped_library_name_with_extension = stripped_library_name + non_debug_suffix;
+
+    const std::string path_separator = getPathSeparator();
+
+    for (unsigned int c = 0; c < all_paths_without_extension.size(); c++) {
+      std::string current_path = all_paths_without_extension.at(c);
+      all_paths.push_back(current_path + path_separator + library_name_with_extension);
+      all_paths.push_back(current_path + path_separator + stripped_library_name_with_extension);
+      // We're in debug mode, try debug libraries as well
+      if (debug_library_suffix) {
+        all_paths.push_back(
+          current_path + path_separator + library_name + class_loader::systemLibrarySuffix());
+        all_paths.push_back(
+          current_path + path_separator + stripped_library_name +
+          class_loader::systemLibrarySuffix());
+      }
+    }
+
+    return all_paths;
+  }
+
+  /// Return the first of getAllLibraryPathsToTry() that exists, or an empty string.
+  static std::string resolve(
+    const std::string & library_name,
+    const std::string & rosbuild_library_path)
+  {
+    return resolve(library_name, rosbuild_library_path, getCatkinLibraryPaths());
+  }
+
+  /// Like resolve(), with the result of getCatkinLibraryPaths() given.
+  static std::string resolve(
+    const std::string & library_name,
+    const std::string & rosbuild_library_path,
+    const std::vector<std::string> & catkin_library_paths)
+  {
+    std::vector<std::string> paths_to_try =
+      getAllLibraryPathsToTry(library_name, rosbuild_library_path, catkin_library_paths);
+
+    ROS_DEBUG_NAMED("pluginlib.ClassLoader",
+      "Iterating through all possible paths where %s could be located...",
+      library_name.c_str());
+    for (std::vector<std::string>::const_iterator path_it = paths_to_try.begin();
+      path_it != paths_to_try.end(); path_it++)
+    {
+      ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Checking path %s ", path_it->c_str());
+      if (DirectoryListingCache::instance().exists(*path_it)) {
+        ROS_DEBUG_NAMED("pluginlib.ClassLoader", "Library %s found at explicit path %s.",
+          library_name.c_str(), path_it->c_str());
+        return *path_it;
+      }
+    }
+    return "";
+  }
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__LIBRARY_PATH_RESOLVER_HPP_
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__LIBRARY_PREFETCHER_HPP_
+#define PLUGINLIB__LIBRARY_PREFETCHER_HPP_
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "boost/cstdint.hpp"
+#include "boost/unordered_set.hpp"
+
+#ifdef __linux__
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <unistd.h>
+#endif
+
+namespace pluginlib
+{
+
+/// What the dynamic section of a shared library tells about the libraries it needs.
+struct ElfDynamicInfo
+{
+  // The DT_NEEDED entries, in order
+  std::vector<std::string> needed;
+  // The directories of DT_RPATH and DT_RUNPATH, $ORIGIN not substituted yet
+  std::vector<std::string> rpath;
+  std::vector<std::string> runpath;
+};
+
+/// Warms the page cache for libraries about to be loaded, and the libraries they need.
+/**
+ * Loading a library from a cold cache faults in its pages, and those of every library it
+ * needs, one at a time. The prefetcher walks the DT_NEEDED entries of the libraries, finding
+ * each the way the dynamic linker would, and asks the kernel to read the files in the
+ * background with posix_fadvise(POSIX_FADV_WILLNEED), so that the faults of a later dlopen()
+ * hit the cache. Libraries the process has loaded already are skipped, along with what they
+ * need. The ld.so.cache is not read; the directories of the loaded libraries stand in for it.
+ * Only ELF libraries of the byte order of the process are walked, and only on Linux; elsewhere
+ * prefetch() does nothing.
+ */
+class LibraryPrefetcher
+{
+public:
+  /// Note the libraries loaded in the process and where the dynamic linker searches.
+  LibraryPrefetcher()
+  {
+#ifdef __linux__
+    const char * env = std::getenv("LD_LIBRARY_PATH");
+    if (env) {
+      splitPaths(env, library_paths_);
+    }
+    dl_iterate_phdr(&LibraryPrefetcher::addLoadedObject, this);
+    default_paths_.push_back("/lib");
+    default_paths_.push_back("/usr/lib");
+#endif
+  }
+
+  /// Prefetch the libraries and, transitively, the libraries they need.
+  /**
+   * Files prefetched already by this prefetcher are skipped.
+   *
+   * \param library_paths The paths of the libraries
+   * \return The number of files the kernel was asked to read
+   */
+  size_t prefetch(const std::vector<std::string> & library_paths)
+  {
+    size_t count = 0;
+#ifdef __linux__
+    std::vector<std::string> queue;
+    for (size_t i = 0; i < library_paths.size(); ++i) {
+      if (!isLoaded(library_paths[i]) && visited_.insert(library_paths[i]).second) {
+        queue.push_back(library_paths[i]);
+      }
+    }
+    // Breadth first, so the libraries asked for are read ahead of their dependencies
+    for (size_t i = 0; i < queue.size(); ++i) {
+      const std::string path = queue[i];
+      if (!adviseWillNeed(path)) {
+        continue;
+      }
+      ++count;
+      prefetched_.push_back(path);
+      ElfDynamicInfo info;
+      if (!readDynamicInfo(path, info)) {
+        continue;
+      }
+      for (size_t j = 0; j < info.needed.size(); ++j) {
+        if (loaded_names_.count(info.needed[j])) {
+          continue;
+        }
+        std::string dependency = findDependency(info.needed[j], path, info);
+        if (!dependency.empty() && !isLoaded(dependency) && visited_.insert(dependency).second) {
+          queue.push_back(dependency);
+        }
+      }
+    }
+#else
+    (void)library_paths;
+#endif
+    return count;
+  }
+
+  /// Return the paths of the files prefetched so far, in the order they were.
+  const std::vector<std::string> & getPrefetched() const
+  {
+    return prefetched_;
+  }
+
+  /// Read the dynamic section of a shared library.
+  /**
+   * \return false if the file is no ELF file of the byte order of the process or is malformed
+   */
+  static bool readDynamicInfo(const std::string & path, ElfDynamicInfo & info)
+  {
+#ifdef __linux__
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    unsigned char ident[EI_NIDENT];
+    bool read = false;
+    if (EI_NIDENT == ::pread(fd, ident, EI_NIDENT, 0) &&
+      0 == std::memcmp(ident, ELFMAG, SELFMAG) && isNativeByteOrder(ident[EI_DATA]))
+    {
+      if (ELFCLASS64 == ident[EI_CLASS]) {
+        read = readDynamicInfo<Elf64_Ehdr, Elf64_Phdr, Elf64_Dyn>(fd, info);
+      } else if (ELFCLASS32 == ident[EI_CLASS]) {
+        read = readDynamicInfo<Elf32_Ehdr, Elf32_Phdr, Elf32_Dyn>(fd, info);
+      }
+    }
+    ::close(fd);
+    return read;
+#else
+    (void)path;
+    (void)info;
+    return false;
+#endif
+  }
+
+  /// Ask the kernel to read a whole file into the page cache in the background.
+  static bool adviseWillNeed(const std::string & path)
+  {
+#ifdef __linux__
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    bool advised = 0 == ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+    return advised;
+#else
+    (void)path;
+    return false;
+#endif
+  }
+
+private:
+#ifdef __linux__
+  // Bounds on what is read from a file, which may be corrupt
+  static const size_t kMaxProgramHeaders = 4096;
+  static const size_t kMaxTableSize = 16 * 1024 * 1024;
+
+  static int addLoadedObject(struct dl_phdr_info * object, size_t size, void * data)
+  {
+    (void)size;
+    LibraryPrefetcher * prefetcher = static_cast<LibraryPrefetcher *>(data);
+    std::string path(object->dlpi_name ? object->dlpi_name : "");
+    size_t separator = path.rfind('/');
+    if (std::string::npos == separator) {
+      return 0;
+    }
+    prefetcher->loaded_names_.insert(path.substr(separator + 1));
+    std::string directory = path.substr(0, separator);
+    if (prefetcher->loaded_directories_.insert(directory).second) {
+      prefetcher->default_paths_.push_back(directory);
+    }
+    return 0;
+  }
+
+  static bool isNativeByteOrder(unsigned char data)
+  {
+    const boost::uint16_t one = 1;
+    bool little_endian = 1 == *reinterpret_cast<const unsigned char *>(&one);
+    return data == (little_endian ? ELFDATA2LSB : ELFDATA2MSB);
+  }
+
+  static void splitPaths(const std::string & paths, std::vector<std::string> & directories)
+  {
+    size_t begin = 0;
+    while (begin <= paths.size()) {
+      size_t end = paths.find(':', begin);
+      if (std::string::npos == end) {
+        end = paths.size();
+      }
+      if (end > begin) {
+        directories.push_back(paths.substr(begin, end - begin));
+      }
+      begin = end + 1;
+    }
+  }
+
+  template<class Ehdr, class Phdr, class Dyn>
+  static bool readDynamicInfo(int fd, ElfDynamicInfo & info)
+  {
+    Ehdr header;
+    if (static_cast<ssize_t>(sizeof(header)) != ::pread(fd, &header, sizeof(header), 0) ||
+      sizeof(Phdr) != header.e_phentsize || header.e_phnum > kMaxProgramHeaders)
+    {
+      return false;
+    }
+    std::vector<Phdr> program_headers(header.e_phnum);
+    size_t program_headers_size = program_headers.size() * sizeof(Phdr);
+    if (program_headers.empty() ||
+      static_cast<ssize_t>(program_headers_size) !=
+      ::pread(fd, &program_headers[0], program_headers_size, header.e_phoff))
+    {
+      return false;
+    }
+
+    std::vector<Dyn> dynamic;
+    for (size_t i = 0; i < program_headers.size(); ++i) {
+      const Phdr & program_header = program_headers[i];
+      if (PT_DYNAMIC != program_header.p_type) {
+        continue;
+      }
+      if (program_header.p_filesz > kMaxTableSize) {
+        return false;
+      }
+      dynamic.resize(program_header.p_filesz / sizeof(Dyn));
+      size_t dynamic_size = dynamic.size() * sizeof(Dyn);
+      if (dynamic.empty() ||
+        static_cast<ssize_t>(dynamic_size) !=
+        ::pread(fd, &dynamic[0], dynamic_size, program_header.p_offset))
+      {
+        return false;
+      }
+      break;
+    }
+
+    // The string table is given by its address once loaded, which the segments map to the file
+    boost::uint64_t string_table_address = 0;
+    boost::uint64_t string_table_size = 0;
+    for (size_t i = 0; i < dynamic.size() && DT_NULL != dynamic[i].d_tag; ++i) {
+      if (DT_STRTAB == dynamic[i].d_tag) {
+        string_table_address = dynamic[i].d_un.d_ptr;
+      } else if (DT_STRSZ == dynamic[i].d_tag) {
+        string_table_size = dynamic[i].d_un.d_val;
+      }
+    }
+    if (0 == string_table_size || string_table_size > kMaxTableSize) {
+      return 0 == string_table_size && dynamic.empty();
+    }
+    boost::uint64_t string_table_offset = 0;
+    bool mapped = false;
+    for (size_t i = 0; i < program_headers.size() && !mapped; ++i) {
+      const Phdr & program_header = program_headers[i];
+      if (PT_LOAD == program_header.p_type && program_header.p_vaddr <= string_table_address &&
+        string_table_address + string_table_size <=
+        program_header.p_vaddr + program_header.p_filesz)
+      {
+        string_table_offset =
+          string_table_address - program_header.p_vaddr + program_header.p_offset;
+        mapped = true;
+      }
+    }
+    std::vector<char> strings(static_cast<size_t>(string_table_size));
+    if (!mapped ||
+      static_cast<ssize_t>(strings.size()) !=
+      ::pread(fd, &strings[0], strings.size(), static_cast<off_t>(string_table_offset)))
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < dynamic.size() && DT_NULL != dynamic[i].d_tag; ++i) {
+      if (DT_NEEDED != dynamic[i].d_tag && DT_RPATH != dynamic[i].d_tag &&
+        DT_RUNPATH != dynamic[i].d_tag)
+      {
+        continue;
+      }
+      size_t offset = static_cast<size_t>(dynamic[i].d_un.d_val);
+      if (offset >= strings.size()) {
+        return false;
+      }
+      const char * begin = &strings[offset];
+      const void * end = std::memchr(begin, '\0', strings.size() - offset);
+      if (!end) {
+        return false;
+      }
+      std::string value(begin, static_cast<const char *>(end));
+      if (DT_NEEDED == dynamic[i].d_tag) {
+        info.needed.push_back(value);
+      } else {
+        splitPaths(value, DT_RPATH == dynamic[i].d_tag ? info.rpath : info.runpath);
+      }
+    }
+    return true;
+  }
+
+  /// Find a needed library in the order of the dynamic linker, see ld.so(8).
+  std::string findDependency(
+    const std::string & name, const std::string & library_path,
+    const ElfDynamicInfo & info) const
+  {
+    if (std::string::npos != name.find('/')) {
+      return name;
+    }
+    std::string origin = library_path.substr(0, library_path.rfind('/'));
+    std::vector<std::string> directories;
+    if (info.runpath.empty()) {
+      directories.insert(directories.end(), info.rpath.begin(), info.rpath.end());
+    }
+    directories.insert(directories.end(), library_paths_.begin(), library_paths_.end());
+    directories.insert(directories.end(), info.runpath.begin(), info.runpath.end());
+    directories.insert(directories.end(), default_paths_.begin(), default_paths_.end());
+    for (size_t i = 0; i < directories.size(); ++i) {
+      std::string candidate = substituteOrigin(directories[i], origin) + "/" + name;
+      if (0 == ::access(candidate.c_str(), R_OK)) {
+        return candidate;
+      }
+    }
+    return "";
+  }
+
+  static std::string substituteOrigin(const std::string & directory, const std::string & origin)
+  {
+    std::string result = directory;
+    const char * tokens[] = {"${ORIGIN}", "$ORIGIN"};
+    for (size_t i = 0; i < sizeof(tokens) / sizeof(tokens[0]); ++i) {
+      std::string token(tokens[i]);
+      for (size_t position = result.find(token); std::string::npos != position;
+        position = result.find(token, position + origin.size()))
+      {
+        result.replace(position, token.size(), origin);
+      }
+    }
+    return result;
+  }
+
+  bool isLoaded(const std::string & path) const
+  {
+    return loaded_names_.count(path.substr(path.rfind('/') + 1)) > 0;
+  }
+#endif
+
+  // The file names of the objects loaded in the process
+  boost::unordered_set<std::string> loaded_names_;
+  boost::unordered_set<std::string> loaded_directories_;
+  // LD_LIBRARY_PATH
+  std::vector<std::string> library_paths_;
+  // The directories of the loaded objects, then the defaults of the dynamic linker
+  std::vector<std::string> default_paths_;
+  boost::unordered_set<std::string> visited_;
+  std::vector<std::string> prefetched_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__LIBRARY_PREFETCHER_HPP_
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__LOOKUP_KEY_HPP_
+#define PLUGINLIB__LOOKUP_KEY_HPP_
+
+#include <cstddef>
+#include <cstring>
+
+#include "boost/config.hpp"
+#include "boost/cstdint.hpp"
+#include "boost/predef/other/endian.h"
+#include "boost/utility/string_view.hpp"
+
+namespace pluginlib
+{
+
+namespace detail
+{
+
+// The hash is spelled as single-expression functions, so that C++11 can evaluate it at compile
+// time, and reads the bytes one by one, so that it does not depend on the byte order.
+// hashLookupNameAtRuntime() computes the same hash with word loads.
+
+BOOST_CONSTEXPR inline boost::uint64_t shiftXor(boost::uint64_t x, int shift)
+{
+  return x ^ (x >> shift);
+}
+
+/// Finalizer of splitmix64.
+BOOST_CONSTEXPR inline boost::uint64_t mixHash(boost::uint64_t x)
+{
+  return shiftXor(shiftXor(shiftXor(x, 30) * 0xbf58476d1ce4e5b9ULL, 27) * 0x94d049bb133111ebULL,
+           31);
+}
+
+/// Read up to eight bytes as a little-endian word.
+BOOST_CONSTEXPR inline boost::uint64_t loadWord(const char * data, size_t size)
+{
+  return 0 == size ? 0 :
+         static_cast<boost::uint64_t>(static_cast<unsigned char>(data[0])) |
+         (loadWord(data + 1, size - 1) << 8);
+}
+
+BOOST_CONSTEXPR inline boost::uint64_t hashWords(
+  const char * data, size_t size, boost::uint64_t hash)
+{
+  return size >= 8 ?
+         hashWords(data + 8, size - 8, shiftXor((hash ^ loadWord(data, 8)) * 0xff51afd7ed558ccdULL,
+           32)) :
+         mixHash(hash ^ loadWord(data, size));
+}
+
+}  // namespace detail
+
+/// Hash a lookup name, eight bytes at a time; a constant expression since C++11.
+BOOST_CONSTEXPR inline boost::uint64_t hashLookupName(const char * data, size_t size)
+{
+  return detail::hashWords(data, size, 0x9e3779b97f4a7c15ULL ^ size);
+}
+
+/// Like hashLookupName(), but faster for names only known at runtime.
+inline boost::uint64_t hashLookupNameAtRuntime(const char * data, size_t size)
+{
+#if BOOST_ENDIAN_LITTLE_BYTE
+  boost::uint64_t hash = 0x9e3779b97f4a7c15ULL ^ size;
+  boost::uint64_t word;
+  for (; size >= sizeof(word); data += sizeof(word), size -= sizeof(word)) {
+    std::memcpy(&word, data, sizeof(word));
+    hash = detail::shiftXor((hash ^ word) * 0xff51afd7ed558ccdULL, 32);
+  }
+  return detail::mixHash(hash ^ detail::loadWord(data, size));
+#else
+  return hashLookupName(data, size);
+#endif
+}
+
+/// A lookup name together with its hash, for lookups which need not hash the name again.
+/**
+ * With C++11, a key for a name known at compile time is hashed by the compiler when it is a
+ * constant expression, such as a constexpr variable:
+ *
+ * \code
+ * using namespace pluginlib::literals;
+ * constexpr pluginlib::LookupKey kMyPlanner = "my_pkg/MyPlanner"_plugin;
+ * loader.createInstance(kMyPlanner);
+ * \endcode
+ *
+ * Before C++20, a _plugin literal or a LookupKey(const char *, size_t) used elsewhere, e.g. as a
+ * function argument, may be hashed at runtime, a byte at a time, which is slower than the
+ * LookupKey(boost::string_view) constructor.
+ *
+ * The key refers to the name without copying it, so the name must outlive the key.
+ */
+class LookupKey
+{
+public:
+  BOOST_CONSTEXPR LookupKey(const char * name, size_t size)
+  : name_(name), size_(size), hash_(hashLookupName(name, size)) {}
+
+  explicit LookupKey(boost::string_view name)
+  : name_(name.data()), size_(name.size()),
+    hash_(hashLookupNameAtRuntime(name.data(), name.size())) {}
+
+  boost::string_view getName() const
+  {
+    return boost::string_view(name_, size_);
+  }
+
+  BOOST_CONSTEXPR boost::uint64_t getHash() const
+  {
+    return hash_;
+  }
+
+private:
+  const char * name_;
+  size_t size_;
+  boost::uint64_t hash_;
+};
+
+#if __cplusplus >= 201103L
+namespace literals
+{
+
+/// Make a LookupKey, e.g. "my_pkg/MyPlanner"_plugin; always hashed at compile time since C++20.
+#if defined(__cpp_consteval)
+consteval
+#else
+constexpr
+#endif
+LookupKey operator"" _plugin(const char * name, size_t size)
+{
+  return LookupKey(name, size);
+}
+
+}  // namespace literals
+#endif
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__LOOKUP_KEY_HPP_
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__MAPPED_FILE_HPP_
+#define PLUGINLIB__MAPPED_FILE_HPP_
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace pluginlib
+{
+
+/// Read-only view of a whole file, memory mapped where possible.
+/**
+ * On POSIX systems the file is mapped privately and the view stays valid for the lifetime of
+ * the object, regardless of later changes to the file's directory entry. Elsewhere the contents
+ * are read into a buffer.
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string & path)
+  : data_(NULL), size_(0), mapped_(false)
+  {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat st;
+    if (0 != ::fstat(fd, &st)) {
+      ::close(fd);
+      return;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (0 == size_) {
+      ::close(fd);
+      data_ = "";
+      return;
+    }
+    void * data = ::mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (MAP_FAILED == data) {
+      size_ = 0;
+      return;
+    }
+    data_ = static_cast<const char *>(data);
+    mapped_ = true;
+#else
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if (!file) {
+      return;
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    size_ = buffer_.size();
+    data_ = buffer_.empty() ? "" : &buffer_[0];
+#endif
+  }
+
+  ~MappedFile()
+  {
+#ifndef _WIN32
+    if (mapped_) {
+      ::munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+  }
+
+  /// Return whether the file could be opened; empty files are open with size() 0.
+  bool isOpen() const
+  {
+    return NULL != data_;
+  }
+
+  const char * data() const
+  {
+    return data_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+private:
+  MappedFile(const MappedFile &);
+  MappedFile & operator=(const MappedFile &);
+
+  const char * data_;
+  size_t size_;
+  bool mapped_;
+  std::vector<char> buffer_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__MAPPED_FILE_HPP_
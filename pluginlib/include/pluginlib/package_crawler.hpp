@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PACKAGE_CRAWLER_HPP_
+#define PLUGINLIB__PACKAGE_CRAWLER_HPP_
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "boost/bind.hpp"
+#include "boost/filesystem.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "ros/console.h"
+#include "tinyxml2.h"  // NOLINT
+
+#include "./parallel_for.hpp"
+
+namespace pluginlib
+{
+
+/// A package found by the PackageCrawler and what its manifest declares.
+struct CrawledPackage
+{
+  /// A child element of the <export> tag, e.g. <pluginlib plugin="${prefix}/plugins.xml"/>.
+  struct Export
+  {
+    std::string tag;
+    std::map<std::string, std::string> attributes;
+  };
+
+  std::string name;
+  // The directory holding the package manifest.
+  std::string path;
+  std::set<std::string> dependencies;
+  std::vector<Export> exports;
+};
+
+/// Process-wide, rospack-free crawler for packages and the plugins they export.
+/**
+ * Finds packages the way rospack does, below the ROS_PACKAGE_PATH entries, and additionally
+ * below the share directory of every CMAKE_PREFIX_PATH entry. Package manifests are read
+ * directly with tinyxml2, so neither the rospack executable nor its cache files are involved.
+ *
+ * The top-level directories of all search paths are crawled in parallel. The packages found
+ * below each search path are cached for the lifetime of the process, so a search path is only
+ * crawled again when explicitly asked to.
+ */
+class PackageCrawler
+{
+public:
+  /// Return the crawler of this process.
+  static PackageCrawler & instance()
+  {
+    static PackageCrawler crawler;
+    return crawler;
+  }
+
+  /// Return the directories packages are searched in, in order of precedence.
+  static std::vector<std::string> getSearchPaths()
+  {
+#ifdef _WIN32
+    const char * separator = ";";
+#else
+    const char * separator = ":";
+#endif
+    std::vector<std::string> search_paths;
+    const char * ros_package_path = std::getenv("ROS_PACKAGE_PATH");
+    if (ros_package_path) {
+      std::vector<std::string> paths;
+      boost::split(paths, ros_package_path, boost::is_any_of(separator));
+      search_paths.insert(search_paths.end(), paths.begin(), paths.end());
+    }
+    const char * cmake_prefix_path = std::getenv("CMAKE_PREFIX_PATH");
+    if (cmake_prefix_path) {
+      std::vector<std::string> paths;
+      boost::split(paths, cmake_prefix_path, boost::is_any_of(separator));
+      for (size_t i = 0; i < paths.size(); ++i) {
+        if (!paths[i].empty()) {
+          search_paths.push_back((boost::filesystem::path(paths[i]) / "share").string());
+        }
+      }
+    }
+
+    std::vector<std::string> unique_paths;
+    std::set<std::string> seen;
+    for (size_t i = 0; i < search_paths.size(); ++i) {
+      if (!search_paths[i].empty() && seen.insert(search_paths[i]).second) {
+        unique_paths.push_back(search_paths[i]);
+      }
+    }
+    return unique_paths;
+  }
+
+  /// Return the directory of a package, or an empty string if no such package was found.
+  std::string getPath(const std::string & package_name, bool force_recrawl = false)
+  {
+    std::vector<PackageListPtr> lists;
+    PackageMap packages = getPackages(force_recrawl, lists);
+    PackageMap::const_iterator it = packages.find(package_name);
+    return it != packages.end() ? it->second->path : std::string();
+  }
+
+  /// Return what packages declare for a package in their exports, like ros::package::getPlugins.
+  /**
+   * Looks at the package itself and at every package depending on it for export tags named
+   * after the package, and collects the values of their attrib_name attributes. Occurrences of
+   * ${prefix} are replaced with the directory of the exporting package.
+   *
+   * \param package_name The package whose tag to look for, e.g. "pluginlib"
+   * \param attrib_name The attribute to collect, e.g. "plugin"
+   * \param force_recrawl Whether to crawl all search paths again instead of using the cache
+   */
+  std::vector<std::string> getPlugins(
+    const std::string & package_name, const std::string & attrib_name,
+    bool force_recrawl = false)
+  {
+    std::vector<std::string> values;
+    std::vector<PackageListPtr> lists;
+    PackageMap packages = getPackages(force_recrawl, lists);
+    for (PackageMap::const_iterator it = packages.begin(); it != packages.end(); ++it) {
+      const CrawledPackage & package = *it->second;
+      if (package.name != package_name && 0 == package.dependencies.count(package_name)) {
+        continue;
+      }
+      for (size_t i = 0; i < package.exports.size(); ++i) {
+        if (package.exports[i].tag != package_name) {
+          continue;
+        }
+        std::map<std::string, std::string>::const_iterator attribute =
+          package.exports[i].attributes.find(attrib_name);
+        if (attribute != package.exports[i].attributes.end()) {
+          values.push_back(boost::replace_all_copy(attribute->second, "${prefix}", package.path));
+        }
+      }
+    }
+    return values;
+  }
+
+  /// Return every package found, by name, the first one found taking precedence.
+  std::vector<CrawledPackage> getAllPackages(bool force_recrawl = false)
+  {
+    std::vector<PackageListPtr> lists;
+    PackageMap packages = getPackages(force_recrawl, lists);
+    std::vector<CrawledPackage> all_packages;
+    all_packages.reserve(packages.size());
+    for (PackageMap::const_iterator it = packages.begin(); it != packages.end(); ++it) {
+      all_packages.push_back(*it->second);
+    }
+    return all_packages;
+  }
+
+  /// Forget all crawled search paths.
+  void clear()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    search_paths_.clear();
+  }
+
+private:
+  typedef std::vector<CrawledPackage> PackageList;
+  typedef boost::shared_ptr<const PackageList> PackageListPtr;
+  typedef std::map<std::string, const CrawledPackage *> PackageMap;
+
+  // Matches rospack, which guards against symlink loops the same way.
+  static const int kMaxDepth = 1000;
+
+  PackageCrawler() {}
+  PackageCrawler(const PackageCrawler &);
+  PackageCrawler & operator=(const PackageCrawler &);
+
+  /// Return the packages of all search paths by name, the first one found taking precedence.
+  /**
+   * \param lists Receives the package lists the returned pointers point into
+   */
+  PackageMap getPackages(bool force_recrawl, std::vector<PackageListPtr> & lists)
+  {
+    std::vector<std::string> search_paths = getSearchPaths();
+
+    boost::mutex::scoped_lock lock(mutex_);
+    if (force_recrawl) {
+      search_paths_.clear();
+    }
+    std::vector<std::string> pending;
+    for (size_t i = 0; i < search_paths.size(); ++i) {
+      if (0 == search_paths_.count(search_paths[i])) {
+        pending.push_back(search_paths[i]);
+      }
+    }
+    if (!pending.empty()) {
+      crawl(pending);
+    }
+
+    PackageMap packages;
+    for (size_t i = 0; i < search_paths.size(); ++i) {
+      lists.push_back(search_paths_[search_paths[i]]);
+      const PackageList & list = *lists.back();
+      for (size_t j = 0; j < list.size(); ++j) {
+        packages.insert(std::make_pair(list[j].name, &list[j]));
+      }
+    }
+    return packages;
+  }
+
+  /// Crawl the given search paths and cache what was found below each.
+  void crawl(const std::vector<std::string> & search_paths)
+  {
+    ROS_DEBUG_NAMED("pluginlib.PackageCrawler", "Crawling %u search paths for packages.",
+      static_cast<unsigned int>(search_paths.size()));
+
+    // Split the work at the top-level directories, a single search path such as
+    // /opt/ros/<distro>/share holds most packages.
+    std::vector<std::pair<size_t, boost::filesystem::path> > roots;
+    for (size_t i = 0; i < search_paths.size(); ++i) {
+      std::vector<boost::filesystem::path> subdirectories;
+      if (listDirectory(search_paths[i], subdirectories)) {
+        roots.push_back(std::make_pair(i, boost::filesystem::path(search_paths[i])));
+        continue;
+      }
+      for (size_t j = 0; j < subdirectories.size(); ++j) {
+        roots.push_back(std::make_pair(i, subdirectories[j]));
+      }
+    }
+
+    std::vector<PackageList> found(roots.size());
+    parallelFor(roots.size(), getDiscoveryThreadCount(),
+      boost::bind(&PackageCrawler::crawlRoot, &roots, &found, _1));
+
+    std::vector<boost::shared_ptr<PackageList> > lists(search_paths.size());
+    for (size_t i = 0; i < search_paths.size(); ++i) {
+      lists[i].reset(new PackageList());
+    }
+    for (size_t i = 0; i < roots.size(); ++i) {
+      PackageList & list = *lists[roots[i].first];
+      list.insert(list.end(), found[i].begin(), found[i].end());
+    }
+    for (size_t i = 0; i < search_paths.size(); ++i) {
+      search_paths_[search_paths[i]] = lists[i];
+    }
+  }
+
+  static void crawlRoot(
+    const std::vector<std::pair<size_t, boost::filesystem::path> > * roots,
+    std::vector<PackageList> * found, size_t index)
+  {
+    crawlDirectory((*roots)[index].second, 0, (*found)[index]);
+  }
+
+  /// Collect the packages in and below a directory.
+  static void crawlDirectory(
+    const boost::filesystem::path & directory, int depth, PackageList & packages)
+  {
+    if (depth > kMaxDepth) {
+      return;
+    }
+    std::vector<boost::filesystem::path> subdirectories;
+    if (!listDirectory(directory, subdirectories)) {
+      for (size_t i = 0; i < subdirectories.size(); ++i) {
+        crawlDirectory(subdirectories[i], depth + 1, packages);
+      }
+      return;
+    }
+
+    CrawledPackage package;
+    package.path = directory.string();
+    if (boost::filesystem::exists(directory / "package.xml")) {
+      if (!readPackageXML((directory / "package.xml").string(), package)) {
+        return;
+      }
+    } else if (!readManifestXML((directory / "manifest.xml").string(), package)) {
+      return;
+    }
+    package.name = package.name.empty() ? directory.filename().string() : package.name;
+    packages.push_back(package);
+  }
+
+  /// List the subdirectories to crawl, or return true if the directory is a package itself.
+  /**
+   * Like rospack, skips hidden directories and directories containing CATKIN_IGNORE, and does
+   * not descend further where there is a rospack_nosubdirs file.
+   */
+  static bool listDirectory(
+    const boost::filesystem::path & directory,
+    std::vector<boost::filesystem::path> & subdirectories)
+  {
+    boost::system::error_code ec;
+    boost::filesystem::directory_iterator it(directory, ec);
+    if (ec) {
+      return false;
+    }
+    std::vector<boost::filesystem::path> candidates;
+    bool is_package = false;
+    bool descend = true;
+    for (; it != boost::filesystem::directory_iterator(); it.increment(ec)) {
+      if (ec) {
+        break;
+      }
+      std::string name = it->path().filename().string();
+      if ("CATKIN_IGNORE" == name) {
+        return false;
+      } else if ("package.xml" == name || "manifest.xml" == name) {
+        is_package = true;
+      } else if ("rospack_nosubdirs" == name) {
+        descend = false;
+      } else if (!name.empty() && '.' != name[0]) {
+        candidates.push_back(it->path());
+      }
+    }
+    if (is_package || !descend) {
+      return is_package;
+    }
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      if (boost::filesystem::is_directory(candidates[i], ec)) {
+        subdirectories.push_back(candidates[i]);
+      }
+    }
+    std::sort(subdirectories.begin(), subdirectories.end());
+    return false;
+  }
+
+  static void readExports(const tinyxml2::XMLElement * package_node, CrawledPackage & package)
+  {
+    const tinyxml2::XMLElement * export_node = package_node->FirstChildElement("export");
+    if (NULL == export_node) {
+      return;
+    }
+    for (const tinyxml2::XMLElement * node = export_node->FirstChildElement(); node;
+      node = node->NextSiblingElement())
+    {
+      CrawledPackage::Export exported;
+      exported.tag = node->Value();
+      for (const tinyxml2::XMLAttribute * attribute = node->FirstAttribute(); attribute;
+        attribute = attribute->Next())
+      {
+        exported.attributes[attribute->Name()] = attribute->Value();
+      }
+      package.exports.push_back(exported);
+    }
+  }
+
+  /// Read the name, dependencies and exports of a catkin package.
+  static bool readPackageXML(const std::string & package_xml_path, CrawledPackage & package)
+  {
+    tinyxml2::XMLDocument document;
+    document.LoadFile(package_xml_path.c_str());
+    const tinyxml2::XMLElement * package_node = document.FirstChildElement("package");
+    if (NULL == package_node) {
+      ROS_WARN_NAMED("pluginlib.PackageCrawler",
+        "Skipping package manifest %s without a root element.", package_xml_path.c_str());
+      return false;
+    }
+
+    const tinyxml2::XMLElement * name_node = package_node->FirstChildElement("name");
+    if (name_node && name_node->GetText()) {
+      package.name = boost::trim_copy(std::string(name_node->GetText()));
+    }
+    // Any kind of dependency makes a package a dependent, format 1 and 2 tags alike
+    for (const tinyxml2::XMLElement * node = package_node->FirstChildElement(); node;
+      node = node->NextSiblingElement())
+    {
+      if (boost::ends_with(node->Value(), "depend") && node->GetText()) {
+        package.dependencies.insert(boost::trim_copy(std::string(node->GetText())));
+      }
+    }
+    readExports(package_node, package);
+    return true;
+  }
+
+  /// Read the dependencies and exports of a rosbuild package.
+  static bool readManifestXML(const std::string & manifest_xml_path, CrawledPackage & package)
+  {
+    tinyxml2::XMLDocument document;
+    document.LoadFile(manifest_xml_path.c_str());
+    const tinyxml2::XMLElement * package_node = document.FirstChildElement("package");
+    if (NULL == package_node) {
+      ROS_WARN_NAMED("pluginlib.PackageCrawler",
+        "Skipping package manifest %s without a root element.", manifest_xml_path.c_str());
+      return false;
+    }
+
+    for (const tinyxml2::XMLElement * node = package_node->FirstChildElement("depend"); node;
+      node = node->NextSiblingElement("depend"))
+    {
+      const char * dependency = node->Attribute("package");
+      if (dependency) {
+        package.dependencies.insert(dependency);
+      }
+    }
+    readExports(package_node, package);
+    return true;
+  }
+
+  boost::mutex mutex_;
+  // The packages found below each crawled search path, in crawl order.
+  std::map<std::string, PackageListPtr> search_paths_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PACKAGE_CRAWLER_HPP_
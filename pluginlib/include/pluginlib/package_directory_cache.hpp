@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PACKAGE_DIRECTORY_CACHE_HPP_
+#define PLUGINLIB__PACKAGE_DIRECTORY_CACHE_HPP_
+
+#include <map>
+#include <string>
+
+#include "boost/filesystem.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/utility/string_view.hpp"
+#include "pluginlib/mapped_file.hpp"
+#include "pluginlib/plugin_xml_parser.hpp"
+#include "ros/console.h"
+#include "ros/package.h"
+#include "tinyxml2.h"  // NOLINT
+
+namespace pluginlib
+{
+
+/// Process-wide memo of which package, if any, a directory belongs to.
+/**
+ * Resolving the package that exports a plugin XML file means walking up the directory tree and
+ * looking for a package.xml (catkin) or manifest.xml (rosbuild) at every level. This cache
+ * remembers, for every directory it has looked at, which of the two it found and the package
+ * name, including the directories that contain neither. Every directory is therefore probed
+ * and every package.xml parsed at most once per process, however many loaders ask.
+ */
+class PackageDirectoryCache
+{
+public:
+  /// Return the cache of this process.
+  static PackageDirectoryCache & instance()
+  {
+    static PackageDirectoryCache cache;
+    return cache;
+  }
+
+  /// Get the package name from a path to a plugin XML file.
+  /**
+   * \param plugin_xml_file_path The path to the plugin XML file
+   * \param package_directory If given, set to the directory holding the package manifest
+   * \return The name of the exporting package, or an empty string if it cannot be determined
+   */
+  std::string getPackageFromPluginXMLFilePath(
+    const std::string & plugin_xml_file_path,
+    std::string * package_directory = NULL)
+  {
+    boost::filesystem::path parent = boost::filesystem::path(plugin_xml_file_path).parent_path();
+
+    // Figure out exactly which package the passed XML file is exported by.
+    while (true) {
+      boost::shared_ptr<const Directory> directory = probe(parent);
+      if (Directory::PACKAGE_XML == directory->kind ||
+        (Directory::MANIFEST_XML == directory->kind &&
+        // package_path is a substr of passed plugin xml path
+        0 == plugin_xml_file_path.find(directory->package_path)))
+      {
+        if (package_directory) {
+          *package_directory = parent.string();
+        }
+        return directory->package_name;
+      }
+
+      // Recursive case - hop one folder up
+      parent = parent.parent_path().string();
+
+      // Base case - reached root and cannot find what we're looking for
+      if (parent.string().empty()) {
+        return "";
+      }
+    }
+  }
+
+  /// Forget everything, e.g. because packages may have been added or removed.
+  void clear()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    directories_.clear();
+  }
+
+  /// Open a package.xml file and extract the package name (i.e. contents of <name> tag).
+  /**
+   * \param package_xml_path The path to the package.xml file
+   * \return The name of the package if successful, otherwise an empty string
+   */
+  static std::string extractPackageNameFromPackageXML(const std::string & package_xml_path)
+  {
+    {
+      MappedFile file(package_xml_path);
+      boost::string_view name;
+      if (file.isOpen() && PluginXMLParser::parsePackageName(file.data(), file.size(), name)) {
+        return std::string(name.data(), name.size());
+      }
+    }
+
+    tinyxml2::XMLDocument document;
+    document.LoadFile(package_xml_path.c_str());
+    tinyxml2::XMLElement * doc_root_node = document.FirstChildElement("package");
+    if (NULL == doc_root_node) {
+      ROS_ERROR_NAMED("pluginlib.ClassLoader",
+        "Could not find a root element for package manifest at %s.",
+        package_xml_path.c_str());
+      return "";
+    }
+
+    tinyxml2::XMLElement * package_name_node = doc_root_node->FirstChildElement("name");
+    if (NULL == package_name_node || NULL == package_name_node->GetText()) {
+      ROS_ERROR_NAMED("pluginlib.ClassLoader",
+        "package.xml at %s does not have a <name> tag! Cannot determine package "
+        "which exports plugin.",
+        package_xml_path.c_str());
+      return "";
+    }
+
+    return package_name_node->GetText();
+  }
+
+private:
+  /// What probing a directory for a package manifest found.
+  struct Directory
+  {
+    enum Kind
+    {
+      NO_MANIFEST,
+      PACKAGE_XML,
+      MANIFEST_XML
+    };
+
+    Directory()
+    : probed(false), kind(NO_MANIFEST) {}
+
+    // Guards the members below; held while the directory is probed.
+    boost::mutex mutex;
+    bool probed;
+    Kind kind;
+    std::string package_name;
+    // Where rospack locates a rosbuild package, empty for catkin packages.
+    std::string package_path;
+  };
+
+  PackageDirectoryCache() {}
+  PackageDirectoryCache(const PackageDirectoryCache &);
+  PackageDirectoryCache & operator=(const PackageDirectoryCache &);
+
+  boost::shared_ptr<const Directory> probe(const boost::filesystem::path & path)
+  {
+    boost::shared_ptr<Directory> directory;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      boost::shared_ptr<Directory> & entry = directories_[path.string()];
+      if (!entry) {
+        entry.reset(new Directory());
+      }
+      directory = entry;
+    }
+
+    // Probe outside of the cache lock so that threads resolving different directories do not
+    // wait on each other, and threads asking for the same one wait for the first.
+    boost::mutex::scoped_lock lock(directory->mutex);
+    if (!directory->probed) {
+      if (boost::filesystem::exists(path / "package.xml")) {
+        directory->kind = Directory::PACKAGE_XML;
+        directory->package_name = extractPackageNameFromPackageXML((path / "package.xml").string());
+      } else if (boost::filesystem::exists(path / "manifest.xml")) {
+        directory->kind = Directory::MANIFEST_XML;
+#if BOOST_FILESYSTEM_VERSION >= 3
+        directory->package_name = path.filename().string();
+#else
+        directory->package_name = path.filename();
+#endif
+        directory->package_path = ros::package::getPath(directory->package_name);
+      }
+      directory->probed = true;
+    }
+    return directory;
+  }
+
+  boost::mutex mutex_;
+  std::map<std::string, boost::shared_ptr<Directory> > directories_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PACKAGE_DIRECTORY_CACHE_HPP_
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PARALLEL_FOR_HPP_
+#define PLUGINLIB__PARALLEL_FOR_HPP_
+
+#include <cstddef>
+#include <cstdlib>
+
+#include "boost/bind.hpp"
+#include "boost/function.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+namespace pluginlib
+{
+
+/// Return the number of threads discovery may use to crawl and parse in parallel.
+/**
+ * Defaults to the number of hardware threads and can be overridden with the
+ * PLUGINLIB_DISCOVERY_THREADS environment variable; a value of 1 disables parallel discovery.
+ */
+inline size_t getDiscoveryThreadCount()
+{
+  const char * env = std::getenv("PLUGINLIB_DISCOVERY_THREADS");
+  if (env && *env) {
+    long threads = std::strtol(env, NULL, 10);  // NOLINT
+    return threads > 1 ? static_cast<size_t>(threads) : 1;
+  }
+  unsigned int hardware_threads = boost::thread::hardware_concurrency();
+  return hardware_threads > 1 ? hardware_threads : 1;
+}
+
+namespace detail
+{
+
+class ParallelForState
+{
+public:
+  ParallelForState(size_t count, const boost::function<void(size_t)> & body)
+  : count_(count), next_(0), body_(body) {}
+
+  void run()
+  {
+    size_t index;
+    while (next(index)) {
+      body_(index);
+    }
+  }
+
+private:
+  bool next(size_t & index)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    if (next_ >= count_) {
+      return false;
+    }
+    index = next_++;
+    return true;
+  }
+
+  size_t count_;
+  size_t next_;
+  boost::mutex mutex_;
+  const boost::function<void(size_t)> & body_;
+};
+
+}  // namespace detail
+
+/// Call body(i) for every i in [0, count), using at most max_threads threads.
+/**
+ * The calling thread takes part in the work, so max_threads - 1 threads are spawned at most.
+ * Indices are handed out in increasing order but may complete in any order; callers write
+ * their results into per-index slots and combine them afterwards. body must not throw.
+ */
+inline void parallelFor(
+  size_t count, size_t max_threads,
+  const boost::function<void(size_t)> & body)
+{
+  size_t threads = max_threads < count ? max_threads : count;
+  if (threads <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  detail::ParallelForState state(count, body);
+  boost::thread_group workers;
+  try {
+    for (size_t i = 1; i < threads; ++i) {
+      workers.create_thread(boost::bind(&detail::ParallelForState::run, &state));
+    }
+  } catch (const boost::thread_resource_error &) {
+    // Carry on with the threads we got, the calling thread alone suffices.
+  }
+  state.run();
+  workers.join_all();
+}
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PARALLEL_FOR_HPP_
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PLUGIN_CATALOG_HPP_
+#define PLUGINLIB__PLUGIN_CATALOG_HPP_
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "boost/cstdint.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/unordered_map.hpp"
+#include "pluginlib/class_desc_store.hpp"
+#include "pluginlib/plugin_manifest.hpp"
+
+namespace pluginlib
+{
+
+/// The classes of every base class declared by a list of plugin manifests.
+/**
+ * Manifests are parsed once for all base classes, and the catalog partitions their classes by
+ * base class type up front. Loaders for different base classes of the same package and
+ * attribute share one catalog, each taking its view with a single hash lookup.
+ *
+ * The descriptions of all manifests are held in one ClassDescStore, and the views are tables of
+ * its entries. Only the manifests' own data is kept besides; getManifests() copies the classes
+ * back out of the store.
+ *
+ * Manifests that were skipped without parsing leave the catalog incomplete for the base classes
+ * they were not checked against, see isComplete().
+ *
+ * A catalog is never modified once built; a refresh, or a loader it is incomplete for, builds a
+ * new one.
+ */
+class PluginCatalog
+{
+public:
+  typedef ClassDescTable ClassMap;
+  typedef ClassDescTable::ConstPtr ClassMapPtr;
+  typedef boost::shared_ptr<const PluginCatalog> ConstPtr;
+
+  PluginCatalog()
+  : all_parsed_(true), empty_(new ClassMap()) {}
+
+  /// Partition the classes of the manifests; the first declaration of a lookup name wins.
+  explicit PluginCatalog(const std::vector<PluginManifest> & manifests)
+  : all_parsed_(true), empty_(new ClassMap())
+  {
+    ClassDescStore::Builder builder;
+    boost::unordered_map<std::string, std::vector<boost::uint32_t> > partitions;
+    boost::uint32_t entry_count = 0;
+    for (std::vector<PluginManifest>::const_iterator manifest = manifests.begin();
+      manifest != manifests.end(); ++manifest)
+    {
+      if (!manifest->parsed) {
+        // Complete only for the base classes every skipped manifest is known to lack
+        if (all_parsed_) {
+          complete_base_classes_ = manifest->absent_base_classes;
+        } else {
+          std::set<std::string> common;
+          std::set_intersection(complete_base_classes_.begin(), complete_base_classes_.end(),
+            manifest->absent_base_classes.begin(), manifest->absent_base_classes.end(),
+            std::inserter(common, common.end()));
+          complete_base_classes_.swap(common);
+        }
+        all_parsed_ = false;
+      }
+
+      ManifestRecord record;
+      record.manifest.path = manifest->path;
+      record.manifest.stamp = manifest->stamp;
+      record.manifest.parsed = manifest->parsed;
+      record.manifest.absent_base_classes = manifest->absent_base_classes;
+      record.first_entry = entry_count;
+      for (std::map<std::string, PluginManifest::ClassMap>::const_iterator base =
+        manifest->classes.begin(); base != manifest->classes.end(); ++base)
+      {
+        std::vector<boost::uint32_t> & partition = partitions[base->first];
+        for (PluginManifest::ClassMap::const_iterator it = base->second.begin();
+          it != base->second.end(); ++it)
+        {
+          partition.push_back(builder.add(it->second));
+          ++entry_count;
+        }
+      }
+      record.end_entry = entry_count;
+      manifests_.push_back(record);
+    }
+
+    store_ = builder.build();
+    for (boost::unordered_map<std::string, std::vector<boost::uint32_t> >::const_iterator it =
+      partitions.begin(); it != partitions.end(); ++it)
+    {
+      classes_[it->first].reset(new ClassMap(store_, it->second));
+    }
+  }
+
+  /// Return whether the catalog holds all classes of a base class type.
+  bool isComplete(const std::string & base_class) const
+  {
+    return all_parsed_ || complete_base_classes_.count(base_class) > 0;
+  }
+
+  /// Return the classes available for a base class type, which may be empty.
+  ClassMapPtr getClasses(const std::string & base_class) const
+  {
+    boost::unordered_map<std::string, ClassMapPtr>::const_iterator it = classes_.find(base_class);
+    return it != classes_.end() ? it->second : empty_;
+  }
+
+  /// Return the base class types any class is declared for, sorted.
+  std::vector<std::string> getBaseClasses() const
+  {
+    std::vector<std::string> base_classes;
+    for (boost::unordered_map<std::string, ClassMapPtr>::const_iterator it = classes_.begin();
+      it != classes_.end(); ++it)
+    {
+      base_classes.push_back(it->first);
+    }
+    std::sort(base_classes.begin(), base_classes.end());
+    return base_classes;
+  }
+
+  /// Return copies of the manifests the catalog was built from, in order.
+  std::vector<PluginManifest> getManifests() const
+  {
+    std::vector<PluginManifest> manifests;
+    manifests.reserve(manifests_.size());
+    for (size_t i = 0; i < manifests_.size(); ++i) {
+      manifests.push_back(manifests_[i].manifest);
+      PluginManifest & manifest = manifests.back();
+      for (boost::uint32_t entry = manifests_[i].first_entry; entry < manifests_[i].end_entry;
+        ++entry)
+      {
+        ClassDescRef desc(*store_, store_->getEntry(entry));
+        manifest.classes[desc.getBaseClass()].insert(
+          std::make_pair(std::string(desc.getLookupName()), desc.toClassDesc()));
+      }
+    }
+    return manifests;
+  }
+
+  /// Return whether another catalog was built from the same files, unchanged and as far parsed.
+  bool hasSameManifests(const PluginCatalog & other) const
+  {
+    if (manifests_.size() != other.manifests_.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < manifests_.size(); ++i) {
+      const PluginManifest & manifest = manifests_[i].manifest;
+      const PluginManifest & other_manifest = other.manifests_[i].manifest;
+      if (manifest.path != other_manifest.path || manifest.stamp != other_manifest.stamp ||
+        manifest.parsed != other_manifest.parsed ||
+        manifest.absent_base_classes != other_manifest.absent_base_classes)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Return the store holding the classes of all manifests.
+  const ClassDescStore::ConstPtr & getStore() const
+  {
+    return store_;
+  }
+
+private:
+  /// A manifest without its classes, which are the entries [first_entry, end_entry) of store_.
+  struct ManifestRecord
+  {
+    PluginManifest manifest;
+    boost::uint32_t first_entry;
+    boost::uint32_t end_entry;
+  };
+
+  std::vector<ManifestRecord> manifests_;
+  ClassDescStore::ConstPtr store_;
+  bool all_parsed_;
+  // If some manifests were not parsed, the base classes the catalog is complete for anyway.
+  std::set<std::string> complete_base_classes_;
+  boost::unordered_map<std::string, ClassMapPtr> classes_;
+  ClassMapPtr empty_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PLUGIN_CATALOG_HPP_
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PLUGIN_HANDLE_HPP_
+#define PLUGINLIB__PLUGIN_HANDLE_HPP_
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "class_loader/class_loader.hpp"
+#include "class_loader/multi_library_class_loader.hpp"
+#include "pluginlib/exceptions.hpp"
+
+namespace pluginlib
+{
+
+/// Counts the handles keeping each library of a ClassLoader loaded.
+/**
+ * An unload requested while handles keep a library loaded is recorded, and carried out by the
+ * ClassLoader once the last of them is released.
+ */
+class LibraryPins
+{
+public:
+  typedef boost::shared_ptr<LibraryPins> Ptr;
+
+  void acquire(const std::string & library_path)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    ++counts_[library_path];
+  }
+
+  /// Release a handle, returning whether the library is to be unloaded now.
+  bool release(const std::string & library_path)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    std::map<std::string, size_t>::iterator it = counts_.find(library_path);
+    if (it == counts_.end() || 0 != --it->second) {
+      return false;
+    }
+    counts_.erase(it);
+    return deferred_unloads_.erase(library_path) > 0;
+  }
+
+  /// Return the number of handles keeping the library loaded.
+  size_t getCount(const std::string & library_path) const
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    std::map<std::string, size_t>::const_iterator it = counts_.find(library_path);
+    return it == counts_.end() ? 0 : it->second;
+  }
+
+  /// Defer unloading a library until its last handle is released.
+  /**
+   * \return The number of handles keeping the library loaded, 0 if it may be unloaded now
+   */
+  size_t deferUnload(const std::string & library_path)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    std::map<std::string, size_t>::const_iterator it = counts_.find(library_path);
+    if (it == counts_.end()) {
+      return 0;
+    }
+    deferred_unloads_.insert(library_path);
+    return it->second;
+  }
+
+  /// Forget a deferred unload, for a library that was loaded again.
+  void cancelUnload(const std::string & library_path)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    deferred_unloads_.erase(library_path);
+  }
+
+private:
+  mutable boost::mutex mutex_;
+  std::map<std::string, size_t> counts_;
+  std::set<std::string> deferred_unloads_;
+};
+
+template<class T>
+class ClassLoader;
+
+/// A class resolved once by ClassLoader::getPluginHandle(), to create instances of repeatedly.
+/**
+ * Holds the type of the class and the library it was resolved to, so creating an instance skips
+ * finding the lookup name, loading the library if needed and locking the ClassLoader. Instances
+ * are still created through class_loader, which accounts for them as for those of
+ * ClassLoader::createInstance(): a managed instance keeps its library from being unloaded while
+ * it lives.
+ *
+ * The library stays loaded as long as a handle to one of its classes exists; an
+ * unloadLibraryForClass() meanwhile is carried out when the last of them is released.
+ *
+ * Handles are cheap to copy and safe to use from several threads, but must not outlive the
+ * ClassLoader that resolved them. Refreshing the loader does not update existing handles.
+ */
+template<class T>
+class PluginHandle
+{
+public:
+#if __cplusplus >= 201103L
+  typedef class_loader::ClassLoader::UniquePtr<T> UniquePtr;
+#endif
+
+  /// Construct an invalid handle.
+  PluginHandle() {}
+
+  /// Return whether the handle was resolved by a ClassLoader.
+  bool isValid() const
+  {
+    return 0 != state_.get();
+  }
+
+  /// Return the lookup name the handle was resolved for, empty if invalid.
+  const std::string & getLookupName() const
+  {
+    return isValid() ? state_->lookup_name : getEmptyString();
+  }
+
+  /// Return the type of the derived class, empty if invalid.
+  const std::string & getClassType() const
+  {
+    return isValid() ? state_->class_type : getEmptyString();
+  }
+
+  /// Return the path of the library the class was loaded from, empty if invalid.
+  const std::string & getLibraryPath() const
+  {
+    return isValid() ? state_->library_path : getEmptyString();
+  }
+
+  /// Create an instance of the class, deleted by the shared pointer.
+  /**
+   * \throws pluginlib::CreateClassException if the handle is invalid or creation fails
+   */
+  boost::shared_ptr<T> createInstance() const
+  {
+    const State & state = getState();
+    try {
+      return state.lowlevel_class_loader->template createInstance<T>(state.class_type,
+               state.library_path);
+    } catch (const class_loader::CreateClassException & ex) {
+      throw pluginlib::CreateClassException(ex.what());
+    }
+  }
+
+#if __cplusplus >= 201103L
+  /// Create an instance of the class, deleted by the unique pointer.
+  /**
+   * \throws pluginlib::CreateClassException if the handle is invalid or creation fails
+   */
+  UniquePtr createUniqueInstance() const
+  {
+    const State & state = getState();
+    try {
+      return state.lowlevel_class_loader->template createUniqueInstance<T>(state.class_type,
+               state.library_path);
+    } catch (const class_loader::CreateClassException & ex) {
+      throw pluginlib::CreateClassException(ex.what());
+    }
+  }
+#endif
+
+  /// Create an instance of the class, which the caller is responsible for deleting.
+  /**
+   * \throws pluginlib::CreateClassException if the handle is invalid or creation fails
+   */
+  T * createUnmanagedInstance() const
+  {
+    const State & state = getState();
+    try {
+      return state.lowlevel_class_loader->template createUnmanagedInstance<T>(state.class_type,
+               state.library_path);
+    } catch (const class_loader::CreateClassException & ex) {
+      throw pluginlib::CreateClassException(ex.what());
+    }
+  }
+
+private:
+  friend class ClassLoader<T>;
+
+  // Released by the ClassLoader, which then lets go of the library's pin.
+  struct State
+  {
+    State(
+      const std::string & lookup_name, const std::string & class_type,
+      const std::string & library_path,
+      class_loader::MultiLibraryClassLoader * lowlevel_class_loader)
+    : lookup_name(lookup_name), class_type(class_type), library_path(library_path),
+      lowlevel_class_loader(lowlevel_class_loader) {}
+
+    std::string lookup_name;
+    std::string class_type;
+    std::string library_path;
+    class_loader::MultiLibraryClassLoader * lowlevel_class_loader;
+  };
+
+  explicit PluginHandle(const boost::shared_ptr<const State> & state)
+  : state_(state) {}
+
+  const State & getState() const
+  {
+    if (!state_) {
+      throw pluginlib::CreateClassException("Cannot create an instance through an invalid "
+              "plugin handle.");
+    }
+    return *state_;
+  }
+
+  static const std::string & getEmptyString()
+  {
+    static const std::string empty;
+    return empty;
+  }
+
+  boost::shared_ptr<const State> state_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PLUGIN_HANDLE_HPP_
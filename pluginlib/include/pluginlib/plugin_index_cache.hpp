@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PLUGIN_INDEX_CACHE_HPP_
+#define PLUGINLIB__PLUGIN_INDEX_CACHE_HPP_
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "boost/cstdint.hpp"
+#include "boost/filesystem.hpp"
+#include "pluginlib/class_desc.hpp"
+#include "pluginlib/class_desc_store.hpp"
+#include "pluginlib/mapped_file.hpp"
+#include "pluginlib/plugin_manifest.hpp"
+#include "ros/console.h"
+
+namespace pluginlib
+{
+
+/// On-disk index of the ClassDesc records a ClassLoader derived from its plugin manifests.
+/**
+ * Each index file covers one (package, attribute) pair and records, for every manifest, its
+ * path, its ManifestStamp and the classes it declares for any base class, or for manifests that
+ * were not parsed, the base classes they do not declare. Deferred descriptions are recorded by
+ * their location in the manifest. An index is only used when the requested manifest list and
+ * every stamp match exactly, so the cache never hides an edit.
+ * Files are written to a unique temporary name and renamed into place, which makes replacement
+ * atomic for concurrent readers and writers.
+ *
+ * The cache lives in $PLUGINLIB_CACHE_DIR, or else in $ROS_HOME/pluginlib (~/.ros/pluginlib),
+ * next to rospack's own cache. Setting PLUGINLIB_CACHE_DIR to an empty string disables it.
+ */
+class PluginIndexCache
+{
+public:
+  PluginIndexCache(const std::string & package, const std::string & attrib_name)
+  {
+    std::string directory = getCacheDirectory();
+    if (directory.empty()) {
+      return;
+    }
+    std::string key = package + '\0' + attrib_name;
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(fnv1a(key)));
+    path_ = (boost::filesystem::path(directory) / (sanitize(package) + "-" + hash + ".idx"))
+      .string();
+  }
+
+  /// Whether a cache location is configured for this process.
+  bool isEnabled() const
+  {
+    return !path_.empty();
+  }
+
+  /// Return the path of the index file, or an empty string if caching is disabled.
+  const std::string & getPath() const
+  {
+    return path_;
+  }
+
+  /// Load the cached manifests if the index matches the given manifests exactly.
+  /**
+   * \param plugin_xml_paths The manifests the caller is about to parse, in order
+   * \param stamps The current ManifestStamp of each entry in plugin_xml_paths
+   * \param manifests Filled with the cached data on success
+   * \return true if the index is fresh and was loaded, false otherwise
+   */
+  bool load(
+    const std::vector<std::string> & plugin_xml_paths,
+    const std::vector<ManifestStamp> & stamps,
+    std::vector<PluginManifest> & manifests) const
+  {
+#ifndef _WIN32
+    if (path_.empty()) {
+      return false;
+    }
+    MappedFile file(path_);
+    if (!file.isOpen() || file.size() < sizeof(Header)) {
+      return false;
+    }
+    bool fresh = decode(file.data(), file.size(), plugin_xml_paths, stamps, manifests);
+    if (!fresh) {
+      manifests.clear();
+    }
+    ROS_DEBUG_NAMED("pluginlib.PluginIndexCache", "Index %s is %s.", path_.c_str(),
+      fresh ? "fresh" : "stale");
+    return fresh;
+#else
+    (void)plugin_xml_paths;
+    (void)stamps;
+    (void)manifests;
+    return false;
+#endif
+  }
+
+  /// Write the given manifests to the index, atomically replacing any previous version.
+  /**
+   * Failures are logged and otherwise ignored; the cache is purely an optimization.
+   */
+  void store(const std::vector<PluginManifest> & manifests) const
+  {
+#ifndef _WIN32
+    if (path_.empty()) {
+      return;
+    }
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(boost::filesystem::path(path_).parent_path(), ec);
+
+    std::string buffer = encode(manifests);
+    // Each writer, of this process or another, gets a file of its own
+    std::string tmp_template = path_ + ".XXXXXX";
+    std::vector<char> tmp_name(tmp_template.begin(), tmp_template.end());
+    tmp_name.push_back('\0');
+    int fd = ::mkstemp(&tmp_name[0]);
+    if (fd < 0) {
+      ROS_DEBUG_NAMED("pluginlib.PluginIndexCache", "Unable to write index %s.", path_.c_str());
+      return;
+    }
+    std::string tmp_path(&tmp_name[0]);
+    ::fchmod(fd, 0644);
+    size_t written = 0;
+    while (written < buffer.size()) {
+      ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+      if (n <= 0) {
+        break;
+      }
+      written += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    if (written != buffer.size() || 0 != ::rename(tmp_path.c_str(), path_.c_str())) {
+      ROS_DEBUG_NAMED("pluginlib.PluginIndexCache", "Unable to write index %s.", path_.c_str());
+      ::unlink(tmp_path.c_str());
+    }
+#else
+    (void)manifests;
+#endif
+  }
+
+  /// Return the directory index files are kept in, or an empty string if caching is disabled.
+  static std::string getCacheDirectory()
+  {
+    const char * env = std::getenv("PLUGINLIB_CACHE_DIR");
+    if (env) {
+      return env;
+    }
+    env = std::getenv("ROS_HOME");
+    if (env && *env) {
+      return (boost::filesystem::path(env) / "pluginlib").string();
+    }
+    env = std::getenv("HOME");
+    if (env && *env) {
+      return (boost::filesystem::path(env) / ".ros" / "pluginlib").string();
+    }
+    return "";
+  }
+
+  /// 64-bit FNV-1a hash, used to derive stable index file names.
+  static boost::uint64_t fnv1a(const std::string & data)
+  {
+    boost::uint64_t hash = 14695981039346656037ULL;
+    for (std::string::const_iterator it = data.begin(); it != data.end(); ++it) {
+      hash ^= static_cast<unsigned char>(*it);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+private:
+  static const boost::uint32_t kVersion = 4;
+
+  // Layout: Header, ManifestEntry[manifest_count], ClassEntry[class_count], string table.
+  // Strings are NUL-terminated and referenced by their offset in the string table.
+  struct Header
+  {
+    char magic[8];
+    boost::uint32_t version;
+    boost::uint32_t manifest_count;
+    boost::uint32_t class_count;
+    boost::uint32_t string_bytes;
+  };
+
+  struct ManifestEntry
+  {
+    boost::uint32_t path;
+    boost::uint32_t class_count;
+    boost::uint32_t parsed;
+    // The absent base classes of a manifest that was not parsed, separated by newlines.
+    boost::uint32_t absent_base_classes;
+    boost::int64_t mtime_sec;
+    boost::int64_t mtime_nsec;
+    boost::uint64_t inode;
+    boost::uint64_t device;
+    boost::uint64_t size;
+  };
+
+  struct ClassEntry
+  {
+    boost::uint32_t lookup_name;
+    boost::uint32_t derived_class;
+    boost::uint32_t base_class;
+    boost::uint32_t package;
+    // As in ClassDescStore::Entry: a string, or the location of a deferred description.
+    boost::uint32_t description;
+    boost::uint32_t description_length;
+    boost::uint32_t library_name;
+  };
+
+  class StringTable
+  {
+public:
+    boost::uint32_t add(const std::string & str)
+    {
+      std::map<std::string, boost::uint32_t>::const_iterator it = offsets_.find(str);
+      if (it != offsets_.end()) {
+        return it->second;
+      }
+      boost::uint32_t offset = static_cast<boost::uint32_t>(data_.size());
+      data_.append(str.c_str(), str.size() + 1);
+      offsets_.insert(std::make_pair(str, offset));
+      return offset;
+    }
+
+    const std::string & data() const
+    {
+      return data_;
+    }
+
+private:
+    std::string data_;
+    std::map<std::string, boost::uint32_t> offsets_;
+  };
+
+  static const char * magic()
+  {
+    return "PLGNIDX";
+  }
+
+  static std::string sanitize(const std::string & name)
+  {
+    std::string result(name);
+    for (std::string::iterator it = result.begin(); it != result.end(); ++it) {
+      char c = *it;
+      if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+        c == '_' || c == '-'))
+      {
+        *it = '_';
+      }
+    }
+    return result;
+  }
+
+  static std::string encode(const std::vector<PluginManifest> & manifests)
+  {
+    StringTable strings;
+    std::vector<ManifestEntry> manifest_entries;
+    std::vector<ClassEntry> class_entries;
+    for (size_t i = 0; i < manifests.size(); ++i) {
+      const PluginManifest & manifest = manifests[i];
+      ManifestEntry entry;
+      entry.path = strings.add(manifest.path);
+      entry.class_count = 0;
+      entry.parsed = manifest.parsed ? 1 : 0;
+      entry.absent_base_classes = strings.add(
+        boost::algorithm::join(manifest.absent_base_classes, "\n"));
+      entry.mtime_sec = manifest.stamp.mtime_sec;
+      entry.mtime_nsec = manifest.stamp.mtime_nsec;
+      entry.inode = manifest.stamp.inode;
+      entry.device = manifest.stamp.device;
+      entry.size = manifest.stamp.size;
+      for (std::map<std::string, PluginManifest::ClassMap>::const_iterator base =
+        manifest.classes.begin(); base != manifest.classes.end(); ++base)
+      {
+        for (PluginManifest::ClassMap::const_iterator it = base->second.begin();
+          it != base->second.end(); ++it)
+        {
+          const ClassDesc & desc = it->second;
+          ClassEntry class_entry;
+          class_entry.lookup_name = strings.add(desc.lookup_name_);
+          class_entry.derived_class = strings.add(desc.derived_class_);
+          class_entry.base_class = strings.add(desc.base_class_);
+          class_entry.package = strings.add(desc.package_);
+          if (desc.isDescriptionDeferred()) {
+            class_entry.description = static_cast<boost::uint32_t>(desc.description_offset_);
+            class_entry.description_length =
+              static_cast<boost::uint32_t>(desc.description_length_);
+          } else {
+            class_entry.description = strings.add(desc.description_);
+            class_entry.description_length = ClassDescStore::kInlineDescription;
+          }
+          class_entry.library_name = strings.add(desc.library_name_);
+          class_entries.push_back(class_entry);
+          ++entry.class_count;
+        }
+      }
+      manifest_entries.push_back(entry);
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic(), sizeof(header.magic));
+    header.version = kVersion;
+    header.manifest_count = static_cast<boost::uint32_t>(manifest_entries.size());
+    header.class_count = static_cast<boost::uint32_t>(class_entries.size());
+    header.string_bytes = static_cast<boost::uint32_t>(strings.data().size());
+
+    std::string buffer;
+    buffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!manifest_entries.empty()) {
+      buffer.append(reinterpret_cast<const char *>(&manifest_entries[0]),
+        manifest_entries.size() * sizeof(ManifestEntry));
+    }
+    if (!class_entries.empty()) {
+      buffer.append(reinterpret_cast<const char *>(&class_entries[0]),
+        class_entries.size() * sizeof(ClassEntry));
+    }
+    buffer.append(strings.data());
+    return buffer;
+  }
+
+  static bool decode(
+    const char * data, size_t length,
+    const std::vector<std::string> & plugin_xml_paths,
+    const std::vector<ManifestStamp> & stamps,
+    std::vector<PluginManifest> & manifests)
+  {
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (0 != std::memcmp(header.magic, magic(), sizeof(header.magic)) ||
+      header.version != kVersion || header.manifest_count != plugin_xml_paths.size())
+    {
+      return false;
+    }
+    size_t manifests_offset = sizeof(Header);
+    size_t classes_offset = manifests_offset +
+      static_cast<size_t>(header.manifest_count) * sizeof(ManifestEntry);
+    size_t strings_offset = classes_offset +
+      static_cast<size_t>(header.class_count) * sizeof(ClassEntry);
+    if (strings_offset + header.string_bytes != length ||
+      (header.string_bytes > 0 && data[length - 1] != '\0'))
+    {
+      return false;
+    }
+    const char * strings = data + strings_offset;
+    const boost::uint32_t string_bytes = header.string_bytes;
+
+    manifests.resize(header.manifest_count);
+    size_t class_index = 0;
+    for (boost::uint32_t i = 0; i < header.manifest_count; ++i) {
+      ManifestEntry entry;
+      std::memcpy(&entry, data + manifests_offset + i * sizeof(ManifestEntry), sizeof(entry));
+      if (entry.path >= string_bytes || plugin_xml_paths[i] != strings + entry.path ||
+        entry.absent_base_classes >= string_bytes)
+      {
+        return false;
+      }
+      PluginManifest & manifest = manifests[i];
+      manifest.path = plugin_xml_paths[i];
+      manifest.stamp.mtime_sec = entry.mtime_sec;
+      manifest.stamp.mtime_nsec = entry.mtime_nsec;
+      manifest.stamp.inode = entry.inode;
+      manifest.stamp.device = entry.device;
+      manifest.stamp.size = entry.size;
+      manifest.parsed = 0 != entry.parsed;
+      if (!manifest.parsed) {
+        std::string absent_base_classes(strings + entry.absent_base_classes);
+        boost::algorithm::split(manifest.absent_base_classes, absent_base_classes,
+          boost::is_any_of("\n"));
+      }
+      if (manifest.stamp != stamps[i] || class_index + entry.class_count > header.class_count) {
+        return false;
+      }
+      for (boost::uint32_t c = 0; c < entry.class_count; ++c, ++class_index) {
+        ClassEntry class_entry;
+        std::memcpy(&class_entry, data + classes_offset + class_index * sizeof(ClassEntry),
+          sizeof(class_entry));
+        bool deferred = ClassDescStore::kInlineDescription != class_entry.description_length;
+        if (class_entry.lookup_name >= string_bytes || class_entry.derived_class >= string_bytes ||
+          class_entry.base_class >= string_bytes || class_entry.package >= string_bytes ||
+          (!deferred && class_entry.description >= string_bytes) ||
+          class_entry.library_name >= string_bytes)
+        {
+          return false;
+        }
+        std::string lookup_name(strings + class_entry.lookup_name);
+        ClassDesc desc(lookup_name, strings + class_entry.derived_class,
+          strings + class_entry.base_class, strings + class_entry.package,
+          deferred ? "" : strings + class_entry.description, strings + class_entry.library_name,
+          manifest.path);
+        if (deferred) {
+          desc.deferDescription(class_entry.description, class_entry.description_length);
+        }
+        manifest.classes[strings + class_entry.base_class].insert(
+          std::make_pair(lookup_name, desc));
+      }
+    }
+    return class_index == header.class_count;
+  }
+
+  std::string path_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PLUGIN_INDEX_CACHE_HPP_
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PLUGIN_MANIFEST_HPP_
+#define PLUGINLIB__PLUGIN_MANIFEST_HPP_
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+
+#include "boost/cstdint.hpp"
+#include "boost/filesystem.hpp"
+#include "pluginlib/class_desc.hpp"
+
+namespace pluginlib
+{
+
+/// Filesystem identity of a plugin manifest, used to decide whether cached data is stale.
+struct ManifestStamp
+{
+  ManifestStamp()
+  : mtime_sec(0), mtime_nsec(0), inode(0), device(0), size(0) {}
+
+  /// Stat a file; a missing file yields a default (all zero) stamp.
+  static ManifestStamp of(const std::string & path)
+  {
+    ManifestStamp stamp;
+#ifndef _WIN32
+    struct stat st;
+    if (0 == ::stat(path.c_str(), &st)) {
+      stamp.mtime_sec = static_cast<boost::int64_t>(st.st_mtime);
+#if defined(__APPLE__)
+      stamp.mtime_nsec = static_cast<boost::int64_t>(st.st_mtimespec.tv_nsec);
+#else
+      stamp.mtime_nsec = static_cast<boost::int64_t>(st.st_mtim.tv_nsec);
+#endif
+      stamp.inode = static_cast<boost::uint64_t>(st.st_ino);
+      stamp.device = static_cast<boost::uint64_t>(st.st_dev);
+      stamp.size = static_cast<boost::uint64_t>(st.st_size);
+    }
+#else
+    boost::system::error_code ec;
+    std::time_t mtime = boost::filesystem::last_write_time(path, ec);
+    if (!ec) {
+      stamp.mtime_sec = static_cast<boost::int64_t>(mtime);
+      stamp.size = static_cast<boost::uint64_t>(boost::filesystem::file_size(path, ec));
+    }
+#endif
+    return stamp;
+  }
+
+  bool operator==(const ManifestStamp & other) const
+  {
+    return mtime_sec == other.mtime_sec && mtime_nsec == other.mtime_nsec &&
+           inode == other.inode && device == other.device && size == other.size;
+  }
+
+  bool operator!=(const ManifestStamp & other) const
+  {
+    return !(*this == other);
+  }
+
+  boost::int64_t mtime_sec;
+  boost::int64_t mtime_nsec;
+  boost::uint64_t inode;
+  boost::uint64_t device;
+  boost::uint64_t size;
+};
+
+/// The classes one plugin manifest declares, for every base class.
+/**
+ * A manifest whose raw bytes showed it declares none of the base classes a loader looked for is
+ * not parsed. It then only records which base classes it lacks, and has to be parsed before
+ * the classes of any other base class can be known.
+ */
+struct PluginManifest
+{
+  // Keyed by lookup name.
+  typedef std::map<std::string, ClassDesc> ClassMap;
+
+  PluginManifest()
+  : parsed(true) {}
+
+  /// Whether the classes of a base class type are known.
+  bool isComplete(const std::string & base_class) const
+  {
+    return parsed || absent_base_classes.count(base_class) > 0;
+  }
+
+  std::string path;
+  ManifestStamp stamp;
+  // By base class type; the first declaration of a lookup name for a base class in the file wins.
+  std::map<std::string, ClassMap> classes;
+  // Whether classes holds everything the file declares.
+  bool parsed;
+  // If the file was not parsed, the base classes it was found not to declare.
+  std::set<std::string> absent_base_classes;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PLUGIN_MANIFEST_HPP_
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PLUGIN_WATCHER_HPP_
+#define PLUGINLIB__PLUGIN_WATCHER_HPP_
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "boost/bind.hpp"
+#include "boost/function.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+#include "ros/console.h"
+
+namespace pluginlib
+{
+
+/// The kind of change reported to plugin event callbacks.
+enum PluginEvent
+{
+  PLUGIN_ADDED,
+  PLUGIN_REMOVED,
+  PLUGIN_CHANGED
+};
+
+/// Watches a set of directories with inotify and reports changes from a background thread.
+/**
+ * Changes are batched: the callback runs once the watched directories have been quiet for a
+ * short while, with the paths of every entry that was created, written, moved or deleted in
+ * the meantime. An empty path in the batch means events were lost and anything may have
+ * changed.
+ *
+ * Only Linux is supported; elsewhere isSupported() returns false and nothing is watched.
+ */
+class PluginWatcher
+{
+public:
+  typedef boost::function<void (const std::set<std::string> & changed_paths)> Callback;
+
+  explicit PluginWatcher(const Callback & callback)
+  : callback_(callback), inotify_fd_(-1)
+  {
+    wake_pipe_[0] = wake_pipe_[1] = -1;
+#ifdef __linux__
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+      ROS_ERROR_NAMED("pluginlib.PluginWatcher", "inotify is not available: %s",
+        strerror(errno));
+      return;
+    }
+    if (0 != ::pipe(wake_pipe_)) {
+      ::close(inotify_fd_);
+      inotify_fd_ = -1;
+      return;
+    }
+    thread_ = boost::thread(boost::bind(&PluginWatcher::run, this));
+#endif
+  }
+
+  ~PluginWatcher()
+  {
+#ifdef __linux__
+    if (inotify_fd_ >= 0) {
+      char stop = 0;
+      ssize_t written = ::write(wake_pipe_[1], &stop, 1);
+      (void)written;
+      thread_.join();
+      ::close(wake_pipe_[0]);
+      ::close(wake_pipe_[1]);
+      ::close(inotify_fd_);
+    }
+#endif
+  }
+
+  /// Whether the watcher is running and can report changes.
+  bool isSupported() const
+  {
+    return inotify_fd_ >= 0;
+  }
+
+  /// Watch exactly the given directories, adding and removing watches as necessary.
+  /**
+   * Directories that do not exist are skipped.
+   */
+  void watch(const std::set<std::string> & directories)
+  {
+#ifdef __linux__
+    if (inotify_fd_ < 0) {
+      return;
+    }
+    boost::mutex::scoped_lock lock(mutex_);
+    for (std::map<int, std::string>::iterator it = watches_.begin(); it != watches_.end(); ) {
+      if (directories.count(it->second) == 0) {
+        ::inotify_rm_watch(inotify_fd_, it->first);
+        watches_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    std::set<std::string> watched;
+    for (std::map<int, std::string>::const_iterator it = watches_.begin(); it != watches_.end();
+      ++it)
+    {
+      watched.insert(it->second);
+    }
+    for (std::set<std::string>::const_iterator it = directories.begin(); it != directories.end();
+      ++it)
+    {
+      if (watched.count(*it) > 0) {
+        continue;
+      }
+      int wd = ::inotify_add_watch(inotify_fd_, it->c_str(),
+          IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+          IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+      if (wd >= 0) {
+        watches_[wd] = *it;
+      }
+    }
+#else
+    (void)directories;
+#endif
+  }
+
+private:
+  // How long the directories must be quiet before a batch of changes is reported
+  static const int kQuietPeriodMs = 100;
+
+  PluginWatcher(const PluginWatcher &);
+  PluginWatcher & operator=(const PluginWatcher &);
+
+#ifdef __linux__
+  void run()
+  {
+    std::set<std::string> changed_paths;
+    while (true) {
+      struct pollfd fds[2];
+      fds[0].fd = inotify_fd_;
+      fds[0].events = POLLIN;
+      fds[1].fd = wake_pipe_[0];
+      fds[1].events = POLLIN;
+      int ready = ::poll(fds, 2, changed_paths.empty() ? -1 : kQuietPeriodMs);
+      if (ready < 0) {
+        if (EINTR == errno) {
+          continue;
+        }
+        ROS_ERROR_NAMED("pluginlib.PluginWatcher", "Stopped watching plugins: %s",
+          strerror(errno));
+        return;
+      }
+      if (fds[1].revents) {
+        return;
+      }
+      if (0 == ready) {
+        try {
+          callback_(changed_paths);
+        } catch (const std::exception & e) {
+          ROS_ERROR_NAMED("pluginlib.PluginWatcher", "Failed to process plugin changes: %s",
+            e.what());
+        }
+        changed_paths.clear();
+        continue;
+      }
+      readEvents(changed_paths);
+    }
+  }
+
+  void readEvents(std::set<std::string> & changed_paths)
+  {
+    char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    while (true) {
+      ssize_t length = ::read(inotify_fd_, buffer, sizeof(buffer));
+      if (length <= 0) {
+        return;
+      }
+      boost::mutex::scoped_lock lock(mutex_);
+      for (char * ptr = buffer; ptr < buffer + length; ) {
+        const struct inotify_event * event = reinterpret_cast<const struct inotify_event *>(ptr);
+        ptr += sizeof(struct inotify_event) + event->len;
+        if (event->mask & IN_Q_OVERFLOW) {
+          changed_paths.insert("");
+          continue;
+        }
+        std::map<int, std::string>::const_iterator it = watches_.find(event->wd);
+        if (it == watches_.end()) {
+          continue;
+        }
+        if (event->len > 0) {
+          changed_paths.insert(it->second + "/" + event->name);
+        } else {
+          changed_paths.insert(it->second);
+        }
+      }
+    }
+  }
+#endif
+
+  Callback callback_;
+  int inotify_fd_;
+  int wake_pipe_[2];
+  boost::thread thread_;
+  // Guards watches_
+  boost::mutex mutex_;
+  // Watched directories by watch descriptor
+  std::map<int, std::string> watches_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PLUGIN_WATCHER_HPP_
@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__PLUGIN_XML_PARSER_HPP_
+#define PLUGINLIB__PLUGIN_XML_PARSER_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "boost/utility/string_view.hpp"
+
+namespace pluginlib
+{
+
+/// A <class> declaration of a plugin description file, viewing into the parsed buffer.
+struct PluginXMLClass
+{
+  PluginXMLClass()
+  : has_lookup_name(false), has_description(false) {}
+
+  boost::string_view library_path;
+  boost::string_view lookup_name;
+  boost::string_view type;
+  boost::string_view base_class_type;
+  boost::string_view description;
+  bool has_lookup_name;
+  bool has_description;
+};
+
+/// Streaming parser for the fixed schema of plugin description files and package manifests.
+/**
+ * Reads the buffer in a single pass, without building a DOM and without copying: every value it
+ * returns is a view into the buffer. It only understands the constructs these files use in
+ * practice, i.e. elements, attributes, text, comments and processing instructions. Whenever it
+ * meets anything else, such as entity references, CDATA sections in wanted text, a DOCTYPE, or
+ * a document it would have to report as invalid, it gives up and returns false. Callers then
+ * parse the file with tinyxml2, which remains the reference for both results and error messages.
+ */
+class PluginXMLParser
+{
+public:
+  /// Collect the <class> declarations of a plugin description file.
+  /**
+   * \param data The contents of the file, not necessarily NUL terminated
+   * \param size The length of data
+   * \param classes Receives the declarations in document order
+   * \return false if the file has to be parsed with tinyxml2 instead
+   */
+  static bool parseClasses(const char * data, size_t size, std::vector<PluginXMLClass> & classes)
+  {
+    PluginXMLParser parser(data, size);
+    Tag root;
+    if (!parser.parseProlog() || !parser.parseStartTag(root)) {
+      return false;
+    }
+    size_t first_class = classes.size();
+    bool parsed = false;
+    if ("library" == root.name) {
+      parsed = parser.parseLibrary(root, classes);
+    } else if ("class_libraries" == root.name) {
+      parsed = parser.parseClassLibraries(root, classes);
+    }
+    if (!parsed || !parser.parseEpilog()) {
+      classes.resize(first_class);
+      return false;
+    }
+    return true;
+  }
+
+  /// Return the contents of the <name> tag of a package.xml file.
+  /**
+   * \return false if the file has to be parsed with tinyxml2 instead
+   */
+  static bool parsePackageName(const char * data, size_t size, boost::string_view & name)
+  {
+    PluginXMLParser parser(data, size);
+    Tag root;
+    if (!parser.parseProlog() || !parser.parseStartTag(root) || "package" != root.name ||
+      root.self_closing)
+    {
+      return false;
+    }
+    Tag child;
+    bool has_name = false;
+    while (parser.parseChild(root, child)) {
+      if (!has_name && "name" == child.name) {
+        if (!parser.parseText(child, name) || name.empty()) {
+          return false;
+        }
+        has_name = true;
+      } else if (!parser.skipElement(child, 0)) {
+        return false;
+      }
+    }
+    return has_name && parser.ok_ && parser.parseEpilog();
+  }
+
+  /// Return whether a plugin description file may declare classes of a base class type.
+  /**
+   * Scans the raw bytes for the type name, which every declaration of such a class contains
+   * unless it spells the name with references. The answer errs on the safe side: false means
+   * no class of the type is declared, true only that the file has to be parsed to find out.
+   * \param data The contents of the file, not necessarily NUL terminated
+   * \param size The length of data
+   * \param base_class The base class type, as given to the ClassLoader
+   */
+  static bool mayDeclareBaseClass(const char * data, size_t size, const std::string & base_class)
+  {
+    // Characters that may be escaped with entity references end the part looked for
+    size_t length = base_class.find_first_of("<>&\"'");
+    if (std::string::npos == length) {
+      length = base_class.size();
+    }
+    if (0 == length || contains(data, size, base_class.data(), length)) {
+      return true;
+    }
+    // Character references can stand for any character of the name
+    return contains(data, size, "&#", 2);
+  }
+
+private:
+  struct Tag
+  {
+    Tag()
+    : self_closing(false) {}
+
+    boost::string_view name;
+    // The raw attribute list, validated by parseStartTag().
+    boost::string_view attributes;
+    bool self_closing;
+  };
+
+  // Documents nesting deeper than this are left to tinyxml2.
+  static const int kMaxDepth = 64;
+
+  /// Search for a byte string with memchr(), which the C library vectorizes.
+  static bool contains(const char * data, size_t size, const char * needle, size_t length)
+  {
+    const char * end = data + size;
+    for (const char * p = data; static_cast<size_t>(end - p) >= length; ++p) {
+      p = static_cast<const char *>(std::memchr(p, needle[0], end - p - length + 1));
+      if (NULL == p) {
+        return false;
+      }
+      if (0 == std::memcmp(p, needle, length)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  PluginXMLParser(const char * data, size_t size)
+  : cursor_(data), end_(data + size), ok_(true) {}
+
+  static bool isSpace(char c)
+  {
+    return ' ' == c || '\t' == c || '\n' == c || '\r' == c;
+  }
+
+  static bool isNameChar(char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           '_' == c || ':' == c || '-' == c || '.' == c || (c & 0x80);
+  }
+
+  bool startsWith(const char * prefix) const
+  {
+    size_t length = std::strlen(prefix);
+    return static_cast<size_t>(end_ - cursor_) >= length &&
+           0 == std::memcmp(cursor_, prefix, length);
+  }
+
+  bool skipPast(const char * terminator)
+  {
+    size_t length = std::strlen(terminator);
+    for (const char * p = cursor_; static_cast<size_t>(end_ - p) >= length; ++p) {
+      if (0 == std::memcmp(p, terminator, length)) {
+        cursor_ = p + length;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void skipSpace()
+  {
+    while (cursor_ < end_ && isSpace(*cursor_)) {
+      ++cursor_;
+    }
+  }
+
+  /// Skip whitespace, comments and processing instructions.
+  bool skipMisc()
+  {
+    while (true) {
+      skipSpace();
+      if (startsWith("<!--")) {
+        if (!skipPast("-->")) {
+          return false;
+        }
+      } else if (startsWith("<?")) {
+        if (!skipPast("?>")) {
+          return false;
+        }
+      } else {
+        return true;
+      }
+    }
+  }
+
+  bool parseProlog()
+  {
+    if (startsWith("\xEF\xBB\xBF")) {
+      cursor_ += 3;
+    }
+    return skipMisc() && cursor_ < end_ && '<' == *cursor_ && !startsWith("<!");
+  }
+
+  bool parseEpilog()
+  {
+    return skipMisc() && cursor_ == end_;
+  }
+
+  boost::string_view parseName()
+  {
+    const char * begin = cursor_;
+    while (cursor_ < end_ && isNameChar(*cursor_)) {
+      ++cursor_;
+    }
+    return boost::string_view(begin, cursor_ - begin);
+  }
+
+  /// Parse "<name attributes>" or "<name attributes/>" at the cursor.
+  bool parseStartTag(Tag & tag)
+  {
+    if (cursor_ >= end_ || '<' != *cursor_) {
+      return false;
+    }
+    ++cursor_;
+    tag.name = parseName();
+    if (tag.name.empty()) {
+      return false;
+    }
+    const char * attributes_begin = cursor_;
+    while (true) {
+      const char * before_space = cursor_;
+      skipSpace();
+      if (cursor_ >= end_) {
+        return false;
+      }
+      if ('>' == *cursor_ || startsWith("/>")) {
+        tag.attributes = boost::string_view(attributes_begin, before_space - attributes_begin);
+        tag.self_closing = '/' == *cursor_;
+        cursor_ += tag.self_closing ? 2 : 1;
+        return true;
+      }
+      if (before_space == cursor_ || parseName().empty()) {
+        return false;
+      }
+      skipSpace();
+      if (cursor_ >= end_ || '=' != *cursor_) {
+        return false;
+      }
+      ++cursor_;
+      skipSpace();
+      if (cursor_ >= end_ || ('"' != *cursor_ && '\'' != *cursor_)) {
+        return false;
+      }
+      const char * value_end = static_cast<const char *>(
+        std::memchr(cursor_ + 1, *cursor_, end_ - cursor_ - 1));
+      if (NULL == value_end) {
+        return false;
+      }
+      cursor_ = value_end + 1;
+    }
+  }
+
+  /// Find an attribute in a tag parsed by parseStartTag().
+  /**
+   * \param found Set to whether the tag has the attribute
+   * \return false if the value would need decoding or the attribute is given twice
+   */
+  static bool getAttribute(
+    const Tag & tag, const char * name, boost::string_view & value, bool & found)
+  {
+    found = false;
+    const char * p = tag.attributes.data();
+    const char * end = p + tag.attributes.size();
+    while (p < end) {
+      while (p < end && isSpace(*p)) {
+        ++p;
+      }
+      const char * name_begin = p;
+      while (p < end && isNameChar(*p)) {
+        ++p;
+      }
+      boost::string_view attribute_name(name_begin, p - name_begin);
+      while (p < end && '"' != *p && '\'' != *p) {
+        ++p;
+      }
+      if (p >= end) {
+        break;
+      }
+      const char * value_begin = p + 1;
+      const char * value_end = static_cast<const char *>(std::memchr(value_begin, *p, end - p - 1));
+      p = value_end + 1;
+      if (attribute_name == name) {
+        if (found) {
+          return false;
+        }
+        found = true;
+        value = boost::string_view(value_begin, value_end - value_begin);
+        if (value.find_first_of("&<\r\t\n") != boost::string_view::npos) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /// Find an attribute that has to be present.
+  static bool getRequiredAttribute(const Tag & tag, const char * name, boost::string_view & value)
+  {
+    bool found;
+    return getAttribute(tag, name, value, found) && found;
+  }
+
+  /// Advance to the next child element of parent, or past the end tag of parent.
+  /**
+   * Sets ok_ to false if the content cannot be handled.
+   * \param skip_cdata Whether CDATA sections are skipped, or cannot be handled because their
+   *   text is wanted
+   * \return true if child holds the start tag of the next child element
+   */
+  bool parseChild(const Tag & parent, Tag & child, bool skip_cdata = true)
+  {
+    if (parent.self_closing) {
+      return false;
+    }
+    while (ok_) {
+      const char * text_end = static_cast<const char *>(std::memchr(cursor_, '<', end_ - cursor_));
+      if (NULL == text_end) {
+        ok_ = false;
+        break;
+      }
+      cursor_ = text_end;
+      if (startsWith("<!--")) {
+        ok_ = skipPast("-->");
+      } else if (startsWith("<?")) {
+        ok_ = skipPast("?>");
+      } else if (startsWith("<![CDATA[")) {
+        ok_ = skip_cdata && skipPast("]]>");
+      } else if (startsWith("</")) {
+        cursor_ += 2;
+        ok_ = parseName() == parent.name;
+        skipSpace();
+        ok_ = ok_ && cursor_ < end_ && '>' == *cursor_;
+        if (ok_) {
+          ++cursor_;
+        }
+        return false;
+      } else if (startsWith("<!")) {
+        ok_ = false;
+      } else {
+        ok_ = parseStartTag(child);
+        return ok_;
+      }
+    }
+    return false;
+  }
+
+  /// Skip the content and end tag of an element whose start tag was parsed.
+  bool skipElement(const Tag & tag, int depth)
+  {
+    if (depth > kMaxDepth) {
+      return false;
+    }
+    Tag child;
+    while (parseChild(tag, child)) {
+      if (!skipElement(child, depth + 1)) {
+        return false;
+      }
+    }
+    return ok_;
+  }
+
+  /// Read the text of an element consisting of nothing but verbatim text.
+  bool parseText(const Tag & tag, boost::string_view & text)
+  {
+    if (tag.self_closing) {
+      text = boost::string_view();
+      return true;
+    }
+    const char * begin = cursor_;
+    const char * end = static_cast<const char *>(std::memchr(cursor_, '<', end_ - cursor_));
+    if (NULL == end) {
+      return false;
+    }
+    text = boost::string_view(begin, end - begin);
+    // Entities and line endings would need decoding; whitespace-only text is dropped by tinyxml2.
+    if (text.find_first_of("&\r") != boost::string_view::npos ||
+      (!text.empty() && text.find_first_not_of(" \t\n") == boost::string_view::npos))
+    {
+      return false;
+    }
+    cursor_ = end;
+    Tag child;
+    // tinyxml2 takes the text of a CDATA section as the element's text
+    return !parseChild(tag, child, false) && ok_;
+  }
+
+  bool parseClassLibraries(const Tag & root, std::vector<PluginXMLClass> & classes)
+  {
+    Tag child;
+    while (parseChild(root, child)) {
+      bool parsed = "library" == child.name ? parseLibrary(child, classes) : skipElement(child, 1);
+      if (!parsed) {
+        return false;
+      }
+    }
+    return ok_;
+  }
+
+  bool parseLibrary(const Tag & library, std::vector<PluginXMLClass> & classes)
+  {
+    boost::string_view library_path;
+    if (!getRequiredAttribute(library, "path", library_path) || library_path.empty()) {
+      return false;
+    }
+    Tag child;
+    while (parseChild(library, child)) {
+      bool parsed = "class" == child.name ?
+        parseClass(child, library_path, classes) : skipElement(child, 2);
+      if (!parsed) {
+        return false;
+      }
+    }
+    return ok_;
+  }
+
+  bool parseClass(
+    const Tag & class_tag, const boost::string_view & library_path,
+    std::vector<PluginXMLClass> & classes)
+  {
+    PluginXMLClass declaration;
+    declaration.library_path = library_path;
+    if (!getRequiredAttribute(class_tag, "type", declaration.type) ||
+      !getRequiredAttribute(class_tag, "base_class_type", declaration.base_class_type) ||
+      !getAttribute(class_tag, "name", declaration.lookup_name, declaration.has_lookup_name))
+    {
+      return false;
+    }
+
+    Tag child;
+    while (parseChild(class_tag, child)) {
+      bool parsed;
+      if (!declaration.has_description && "description" == child.name) {
+        declaration.has_description = true;
+        parsed = parseText(child, declaration.description);
+      } else {
+        parsed = skipElement(child, 3);
+      }
+      if (!parsed) {
+        return false;
+      }
+    }
+    if (!ok_) {
+      return false;
+    }
+    classes.push_back(declaration);
+    return true;
+  }
+
+  const char * cursor_;
+  const char * end_;
+  // Cleared when parseChild() met content it cannot handle.
+  bool ok_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__PLUGIN_XML_PARSER_HPP_
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__RESOLUTION_CONTEXT_HPP_
+#define PLUGINLIB__RESOLUTION_CONTEXT_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/cstdint.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "pluginlib/library_path_resolver.hpp"
+#include "ros/package.h"
+
+namespace pluginlib
+{
+
+/// Snapshot of the environment libraries are resolved in, shared by the whole process.
+/**
+ * Holds the library directories of CMAKE_PREFIX_PATH, read and split once, and remembers the
+ * path of every package asked for, which may otherwise take a call of rospack each. Changes
+ * of the environment or of the packages go unnoticed until invalidate() is called, which
+ * refreshing any ClassLoader does; the next getCurrent() then takes a new snapshot.
+ */
+class ResolutionContext
+{
+public:
+  typedef boost::shared_ptr<const ResolutionContext> ConstPtr;
+
+  /// Return the current snapshot, taking one if there is none.
+  static ConstPtr getCurrent()
+  {
+    State & state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    if (!state.current) {
+      state.current.reset(new ResolutionContext(++state.generation));
+    }
+    return state.current;
+  }
+
+  /// Drop the current snapshot, e.g. because CMAKE_PREFIX_PATH or the packages changed.
+  static void invalidate()
+  {
+    State & state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    state.current.reset();
+  }
+
+  /// Return the number of the snapshot, larger for later ones.
+  boost::uint64_t getGeneration() const
+  {
+    return generation_;
+  }
+
+  /// Return LibraryPathResolver::getCatkinLibraryPaths() as of the snapshot.
+  const std::vector<std::string> & getCatkinLibraryPaths() const
+  {
+    return catkin_library_paths_;
+  }
+
+  /// Return the path of a package as by ros::package::getPath(), asking only once.
+  std::string getPackagePath(const std::string & package) const
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      std::map<std::string, std::string>::const_iterator it = package_paths_.find(package);
+      if (it != package_paths_.end()) {
+        return it->second;
+      }
+    }
+    // Not under the lock, which would make every thread wait for rospack
+    std::string package_path = ros::package::getPath(package);
+    boost::mutex::scoped_lock lock(mutex_);
+    return package_paths_.insert(std::make_pair(package, package_path)).first->second;
+  }
+
+  /// Return the path of a library as by LibraryPathResolver::resolve(), without the environment.
+  std::string resolve(const std::string & library_name, const std::string & package) const
+  {
+    return LibraryPathResolver::resolve(library_name, getPackagePath(package),
+             catkin_library_paths_);
+  }
+
+private:
+  struct State
+  {
+    State()
+    : generation(0) {}
+
+    boost::mutex mutex;
+    boost::uint64_t generation;
+    ConstPtr current;
+  };
+
+  explicit ResolutionContext(boost::uint64_t generation)
+  : generation_(generation),
+    catkin_library_paths_(LibraryPathResolver::getCatkinLibraryPaths()) {}
+
+  ResolutionContext(const ResolutionContext &);
+  ResolutionContext & operator=(const ResolutionContext &);
+
+  static State & getState()
+  {
+    static State state;
+    return state;
+  }
+
+  boost::uint64_t generation_;
+  std::vector<std::string> catkin_library_paths_;
+  // Guards package_paths_.
+  mutable boost::mutex mutex_;
+  mutable std::map<std::string, std::string> package_paths_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__RESOLUTION_CONTEXT_HPP_
@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__WORKSPACE_INDEX_HPP_
+#define PLUGINLIB__WORKSPACE_INDEX_HPP_
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "boost/bind.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "pluginlib/class_desc.hpp"
+#include "pluginlib/library_path_resolver.hpp"
+#include "pluginlib/mapped_file.hpp"
+#include "pluginlib/package_crawler.hpp"
+#include "pluginlib/package_directory_cache.hpp"
+#include "pluginlib/parallel_for.hpp"
+#include "pluginlib/plugin_xml_parser.hpp"
+#include "ros/console.h"
+#include "tinyxml2.h"  // NOLINT
+
+namespace pluginlib
+{
+
+/// Every plugin exported in a workspace, crawled and parsed once ahead of time.
+/**
+ * Built offline by the pluginlib_index tool, e.g. when baking a container image, and used by
+ * every ClassLoader of a process whose PLUGINLIB_INDEX environment variable names the file.
+ * Discovery then amounts to reading that one file: no crawling, no stat() of manifests and no
+ * XML parsing, and the library paths are resolved already.
+ *
+ * The index is a snapshot. It is ignored when the package search paths differ from the ones it
+ * was built for, and must be rebuilt whenever packages or plugin descriptions change.
+ *
+ * The file is line based and sorted, so that identical workspaces yield identical files:
+ *
+ *     pluginlib_index <version>
+ *     search_path <path>                      (in order of precedence)
+ *     package <name> <path>                   (by name)
+ *     export <package> <attribute> <plugin_xml>   (by package and attribute, then crawl order)
+ *     manifest <plugin_xml>                   (by path), followed by its classes:
+ *     class <lookup_name> <type> <base_class> <package> <library> <resolved_library> <description>
+ *
+ * Fields are separated by tabs; tabs, newlines and backslashes in values are escaped.
+ */
+class WorkspaceIndex
+{
+public:
+  typedef boost::shared_ptr<const WorkspaceIndex> ConstPtr;
+
+  /// The classes a plugin description file declares, for all base classes.
+  struct Manifest
+  {
+    std::vector<ClassDesc> classes;
+  };
+
+  /// Crawl the current search paths with the PackageCrawler and parse every exported file.
+  static ConstPtr build()
+  {
+    boost::shared_ptr<WorkspaceIndex> index(new WorkspaceIndex());
+    index->search_paths_ = PackageCrawler::getSearchPaths();
+
+    std::vector<CrawledPackage> packages = PackageCrawler::instance().getAllPackages(true);
+    std::set<std::string> package_names;
+    for (size_t i = 0; i < packages.size(); ++i) {
+      index->packages_[packages[i].name] = packages[i].path;
+      package_names.insert(packages[i].name);
+    }
+
+    // The same exports ros::package::getPlugins() reports: tags named after the package itself
+    // or one of its dependencies
+    std::set<std::string> manifest_paths;
+    for (size_t i = 0; i < packages.size(); ++i) {
+      const CrawledPackage & package = packages[i];
+      for (size_t j = 0; j < package.exports.size(); ++j) {
+        const CrawledPackage::Export & exported = package.exports[j];
+        if (0 == package_names.count(exported.tag) ||
+          (exported.tag != package.name && 0 == package.dependencies.count(exported.tag)))
+        {
+          continue;
+        }
+        for (std::map<std::string, std::string>::const_iterator it =
+          exported.attributes.begin(); it != exported.attributes.end(); ++it)
+        {
+          std::string path = boost::replace_all_copy(it->second, "${prefix}", package.path);
+          index->exports_[std::make_pair(exported.tag, it->first)].push_back(path);
+          manifest_paths.insert(path);
+        }
+      }
+    }
+
+    std::vector<std::string> paths(manifest_paths.begin(), manifest_paths.end());
+    std::vector<Manifest> manifests(paths.size());
+    parallelFor(paths.size(), getDiscoveryThreadCount(),
+      boost::bind(&WorkspaceIndex::parseManifest, index.get(), &paths, &manifests, _1));
+    for (size_t i = 0; i < paths.size(); ++i) {
+      index->manifests_[paths[i]] = manifests[i];
+    }
+    return index;
+  }
+
+  /// Read an index file, returning NULL if it cannot be read or is malformed.
+  static ConstPtr load(const std::string & path)
+  {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+      ROS_WARN_NAMED("pluginlib.WorkspaceIndex", "Unable to read plugin index %s.", path.c_str());
+      return ConstPtr();
+    }
+    boost::shared_ptr<WorkspaceIndex> index(new WorkspaceIndex());
+    if (!index->decode(file.data(), file.size())) {
+      ROS_WARN_NAMED("pluginlib.WorkspaceIndex", "Ignoring malformed plugin index %s.",
+        path.c_str());
+      return ConstPtr();
+    }
+    return index;
+  }
+
+  /// Return the index named by PLUGINLIB_INDEX, or NULL if there is none or it is stale.
+  /**
+   * The file is read once per process and path.
+   */
+  static ConstPtr getActive()
+  {
+    const char * env = std::getenv("PLUGINLIB_INDEX");
+    if (NULL == env || '\0' == *env) {
+      return ConstPtr();
+    }
+    ActiveIndex & active = getActiveIndex();
+    boost::mutex::scoped_lock lock(active.mutex);
+    if (active.path != env) {
+      active.path = env;
+      active.index = load(env);
+      if (active.index && active.index->search_paths_ != PackageCrawler::getSearchPaths()) {
+        ROS_WARN_NAMED("pluginlib.WorkspaceIndex",
+          "Ignoring plugin index %s, which was built for different package search paths.", env);
+        active.index.reset();
+      }
+    }
+    return active.index;
+  }
+
+  /// Write the index, returning false on failure.
+  bool write(std::ostream & out) const
+  {
+    out << "pluginlib_index\t" << kVersion << "\n";
+    for (size_t i = 0; i < search_paths_.size(); ++i) {
+      out << "search_path\t" << escape(search_paths_[i]) << "\n";
+    }
+    for (std::map<std::string, std::string>::const_iterator it = packages_.begin();
+      it != packages_.end(); ++it)
+    {
+      out << "package\t" << escape(it->first) << "\t" << escape(it->second) << "\n";
+    }
+    for (ExportMap::const_iterator it = exports_.begin(); it != exports_.end(); ++it) {
+      for (size_t i = 0; i < it->second.size(); ++i) {
+        out << "export\t" << escape(it->first.first) << "\t" << escape(it->first.second) <<
+          "\t" << escape(it->second[i]) << "\n";
+      }
+    }
+    for (std::map<std::string, Manifest>::const_iterator it = manifests_.begin();
+      it != manifests_.end(); ++it)
+    {
+      out << "manifest\t" << escape(it->first) << "\n";
+      for (size_t i = 0; i < it->second.classes.size(); ++i) {
+        const ClassDesc & desc = it->second.classes[i];
+        out << "class\t" << escape(desc.lookup_name_) << "\t" << escape(desc.derived_class_) <<
+          "\t" << escape(desc.base_class_) << "\t" << escape(desc.package_) << "\t" <<
+          escape(desc.library_name_) << "\t" << escape(desc.resolved_library_path_) << "\t" <<
+          escape(desc.description_) << "\n";
+      }
+    }
+    return static_cast<bool>(out);
+  }
+
+  /// Return the package search paths the index was built for.
+  const std::vector<std::string> & getSearchPaths() const
+  {
+    return search_paths_;
+  }
+
+  /// Return the directory of a package, or an empty string if it is not indexed.
+  std::string getPackagePath(const std::string & package) const
+  {
+    std::map<std::string, std::string>::const_iterator it = packages_.find(package);
+    return it != packages_.end() ? it->second : std::string();
+  }
+
+  /// Return the plugin description files exported for a package, like getPlugins() would.
+  std::vector<std::string> getPluginXmlPaths(
+    const std::string & package, const std::string & attrib_name) const
+  {
+    ExportMap::const_iterator it = exports_.find(std::make_pair(package, attrib_name));
+    return it != exports_.end() ? it->second : std::vector<std::string>();
+  }
+
+  /// Return the classes declared by a plugin description file, or NULL if it is not indexed.
+  const Manifest * getManifest(const std::string & plugin_xml_path) const
+  {
+    std::map<std::string, Manifest>::const_iterator it = manifests_.find(plugin_xml_path);
+    return it != manifests_.end() ? &it->second : NULL;
+  }
+
+private:
+  typedef std::map<std::pair<std::string, std::string>, std::vector<std::string> > ExportMap;
+
+  struct ActiveIndex
+  {
+    boost::mutex mutex;
+    std::string path;
+    ConstPtr index;
+  };
+
+  static const int kVersion = 1;
+
+  WorkspaceIndex() {}
+
+  static ActiveIndex & getActiveIndex()
+  {
+    static ActiveIndex active;
+    return active;
+  }
+
+  static std::string escape(const std::string & value)
+  {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+      switch (value[i]) {
+        case '\\': escaped += "\\\\"; break;
+        case '\t': escaped += "\\t"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\r': escaped += "\\r"; break;
+        default: escaped += value[i];
+      }
+    }
+    return escaped;
+  }
+
+  static std::string unescape(const std::string & value)
+  {
+    std::string unescaped;
+    unescaped.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+      if ('\\' != value[i] || i + 1 == value.size()) {
+        unescaped += value[i];
+        continue;
+      }
+      char c = value[++i];
+      unescaped += 't' == c ? '\t' : 'n' == c ? '\n' : 'r' == c ? '\r' : c;
+    }
+    return unescaped;
+  }
+
+  bool decode(const char * data, size_t size)
+  {
+    std::string contents(data, size);
+    std::vector<std::string> lines;
+    boost::split(lines, contents, boost::is_any_of("\n"));
+    std::ostringstream header;
+    header << "pluginlib_index\t" << kVersion;
+    if (lines.empty() || lines[0] != header.str()) {
+      return false;
+    }
+
+    Manifest * manifest = NULL;
+    std::string manifest_path;
+    std::vector<std::string> fields;
+    for (size_t i = 1; i < lines.size(); ++i) {
+      if (lines[i].empty()) {
+        continue;
+      }
+      boost::split(fields, lines[i], boost::is_any_of("\t"));
+      for (size_t j = 0; j < fields.size(); ++j) {
+        fields[j] = unescape(fields[j]);
+      }
+      if ("search_path" == fields[0] && 2 == fields.size()) {
+        search_paths_.push_back(fields[1]);
+      } else if ("package" == fields[0] && 3 == fields.size()) {
+        packages_[fields[1]] = fields[2];
+      } else if ("export" == fields[0] && 4 == fields.size()) {
+        exports_[std::make_pair(fields[1], fields[2])].push_back(fields[3]);
+      } else if ("manifest" == fields[0] && 2 == fields.size()) {
+        manifest_path = fields[1];
+        manifest = &manifests_[manifest_path];
+      } else if ("class" == fields[0] && 8 == fields.size() && manifest) {
+        ClassDesc desc(fields[1], fields[2], fields[3], fields[4], fields[7], fields[5],
+          manifest_path);
+        desc.resolved_library_path_ = fields[6];
+        manifest->classes.push_back(desc);
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Collect the classes of all base classes declared by a file, as ClassLoader would.
+  void parseManifest(
+    const std::vector<std::string> * paths, std::vector<Manifest> * manifests, size_t index)
+  {
+    const std::string & path = (*paths)[index];
+    Manifest & manifest = (*manifests)[index];
+    std::vector<PluginXMLClass> declarations;
+    {
+      MappedFile file(path);
+      if (file.isOpen() && PluginXMLParser::parseClasses(file.data(), file.size(), declarations)) {
+        for (size_t i = 0; i < declarations.size(); ++i) {
+          const PluginXMLClass & declaration = declarations[i];
+          std::string type(declaration.type.data(), declaration.type.size());
+          manifest.classes.push_back(ClassDesc(
+              declaration.has_lookup_name ?
+              std::string(declaration.lookup_name.data(), declaration.lookup_name.size()) : type,
+              type,
+              std::string(declaration.base_class_type.data(), declaration.base_class_type.size()),
+              "",
+              declaration.has_description ?
+              std::string(declaration.description.data(), declaration.description.size()) :
+              std::string("No 'description' tag for this plugin in plugin description file."),
+              std::string(declaration.library_path.data(), declaration.library_path.size()),
+              path));
+        }
+      } else {
+        parseManifestWithTinyXML(path, manifest);
+      }
+    }
+
+    std::string package = PackageDirectoryCache::instance().getPackageFromPluginXMLFilePath(path);
+    for (size_t i = 0; i < manifest.classes.size(); ++i) {
+      ClassDesc & desc = manifest.classes[i];
+      desc.package_ = package;
+      desc.resolved_library_path_ =
+        LibraryPathResolver::resolve(desc.library_name_, getPackagePath(package));
+      if (desc.resolved_library_path_.empty()) {
+        desc.resolved_library_path_ = "UNRESOLVED";
+      }
+    }
+  }
+
+  static void parseManifestWithTinyXML(const std::string & path, Manifest & manifest)
+  {
+    tinyxml2::XMLDocument document;
+    document.LoadFile(path.c_str());
+    const tinyxml2::XMLElement * library = document.RootElement();
+    if (library && 0 == std::strcmp(library->Value(), "class_libraries")) {
+      library = library->FirstChildElement("library");
+    } else if (NULL == library || 0 != std::strcmp(library->Value(), "library")) {
+      ROS_WARN_NAMED("pluginlib.WorkspaceIndex",
+        "Skipping %s, which is not a plugin description file.", path.c_str());
+      return;
+    }
+    for (; library; library = library->NextSiblingElement("library")) {
+      const char * library_path = library->Attribute("path");
+      const tinyxml2::XMLElement * class_element = library->FirstChildElement("class");
+      for (; class_element; class_element = class_element->NextSiblingElement("class")) {
+        const char * type = class_element->Attribute("type");
+        const char * base_class_type = class_element->Attribute("base_class_type");
+        if (NULL == library_path || NULL == type || NULL == base_class_type) {
+          ROS_WARN_NAMED("pluginlib.WorkspaceIndex",
+            "Skipping incomplete class declaration in %s.", path.c_str());
+          continue;
+        }
+        const char * lookup_name = class_element->Attribute("name");
+        const tinyxml2::XMLElement * description =
+          class_element->FirstChildElement("description");
+        manifest.classes.push_back(ClassDesc(lookup_name ? lookup_name : type, type,
+          base_class_type, "",
+          description ? (description->GetText() ? description->GetText() : "") :
+          "No 'description' tag for this plugin in plugin description file.",
+          library_path, path));
+      }
+    }
+  }
+
+  std::vector<std::string> search_paths_;
+  // Package directories by name.
+  std::map<std::string, std::string> packages_;
+  // Plugin description files by (package, attribute), in the order getPlugins() reports them.
+  ExportMap exports_;
+  // Classes by plugin description file.
+  std::map<std::string, Manifest> manifests_;
+};
+
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__WORKSPACE_INDEX_HPP_
@@ -0,0 +1,146 @@
+#!/usr/bin/env python
+# Software License Agreement (BSD License)
+#
+# Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above
+#    copyright notice, this list of conditions and the following
+#    disclaimer in the documentation and/or other materials provided
+#    with the distribution.
+#  * Neither the name of the copyright holders nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# Compile a plugin description file into a C++ source file holding a constant table of its
+# classes, which registers itself with pluginlib::CompiledManifestRegistry when linked.
+# Invoked at build time by the pluginlib_compile_manifests() CMake function.
+
+from __future__ import print_function
+
+import argparse
+import sys
+import xml.etree.ElementTree as ElementTree
+
+NO_DESCRIPTION = "No 'description' tag for this plugin in plugin description file."
+
+
+def parse_classes(plugin_xml_path):
+    root = ElementTree.parse(plugin_xml_path).getroot()
+    if root.tag == 'class_libraries':
+        libraries = root.findall('library')
+    elif root.tag == 'library':
+        libraries = [root]
+    else:
+        raise ValueError(
+            "The XML document '%s' given to add must have either \"library\" or "
+            "\"class_libraries\" as the root tag" % plugin_xml_path)
+
+    classes = []
+    for library in libraries:
+        library_path = library.get('path')
+        if not library_path:
+            raise ValueError(
+                'Failed to find Path Attirbute in library element in %s' % plugin_xml_path)
+        for class_element in library.findall('class'):
+            for attribute in ('type', 'base_class_type'):
+                if class_element.get(attribute) is None:
+                    raise ValueError(
+                        "Class could not be loaded. Attribute '%s' in class tag is missing."
+                        % attribute)
+            description = class_element.find('description')
+            if description is None:
+                description_text = NO_DESCRIPTION
+            else:
+                description_text = description.text or ''
+            classes.append((
+                class_element.get('name', class_element.get('type')),
+                class_element.get('type'),
+                class_element.get('base_class_type'),
+                library_path,
+                description_text))
+    return classes
+
+
+def c_string(value):
+    escaped = value.replace('\\', '\\\\').replace('"', '\\"').replace('\n', '\\n') \
+        .replace('\r', '\\r').replace('\t', '\\t')
+    return '"%s"' % escaped
+
+
+def generate(classes, package, relative_path):
+    lines = [
+        '// Generated by pluginlib_compile_manifest.py from %s/%s, do not edit.'
+        % (package, relative_path),
+        '',
+        '#include <cstddef>',
+        '',
+        '#include "pluginlib/compiled_manifest.hpp"',
+        '',
+        'namespace',
+        '{',
+        '',
+    ]
+    if classes:
+        lines.append('PLUGINLIB_COMPILED_MANIFEST_CONST pluginlib::CompiledClass classes[] = {')
+        for plugin_class in classes:
+            lines.append('  {%s},' % ', '.join(c_string(field) for field in plugin_class))
+        lines.append('};')
+        classes_expression = 'classes'
+    else:
+        classes_expression = 'NULL'
+    lines += [
+        '',
+        'PLUGINLIB_COMPILED_MANIFEST_CONST pluginlib::CompiledManifest manifest = {',
+        '  %s, %s, %s, %d' % (c_string(package), c_string(relative_path), classes_expression,
+                              len(classes)),
+        '};',
+        '',
+        'pluginlib::CompiledManifestRegistrar registrar(manifest);',
+        '',
+        '}  // namespace',
+        '',
+    ]
+    return '\n'.join(lines)
+
+
+def main(argv=sys.argv[1:]):
+    parser = argparse.ArgumentParser(
+        description='Compile a plugin description file into a C++ table.')
+    parser.add_argument('plugin_xml', help='the plugin description file')
+    parser.add_argument('package', help='the package exporting the file')
+    parser.add_argument('relative_path', help='the path of the file in the package')
+    parser.add_argument('output', help='the C++ source file to write')
+    args = parser.parse_args(argv)
+
+    try:
+        classes = parse_classes(args.plugin_xml)
+    except (ElementTree.ParseError, ValueError) as e:
+        print('%s: %s' % (args.plugin_xml, e), file=sys.stderr)
+        return 1
+    with open(args.output, 'w') as output:
+        output.write(generate(classes, args.package, args.relative_path))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
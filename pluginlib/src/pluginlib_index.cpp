@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Crawls the package search paths once and writes every exported plugin, with its resolved
+// library, to an index which ClassLoader reads instead of crawling when PLUGINLIB_INDEX names it.
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "boost/filesystem.hpp"
+#include "pluginlib/workspace_index.hpp"
+
+namespace
+{
+
+void printUsage(const char * program)
+{
+  std::cerr << "Usage: " << program << " [--output <file> | --workspace <prefix>]" << std::endl <<
+    std::endl <<
+    "Index the plugins exported by the packages on ROS_PACKAGE_PATH and CMAKE_PREFIX_PATH." <<
+    std::endl << std::endl <<
+    "  --output <file>       write the index to <file> instead of stdout" << std::endl <<
+    "  --workspace <prefix>  write the index to <prefix>/share/pluginlib/plugin_index," <<
+    std::endl <<
+    "                        where the setup files of the workspace pick it up" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  std::string output;
+  for (int i = 1; i < argc; ++i) {
+    if ((0 == std::strcmp(argv[i], "--output") || 0 == std::strcmp(argv[i], "-o")) &&
+      i + 1 < argc)
+    {
+      output = argv[++i];
+    } else if (0 == std::strcmp(argv[i], "--workspace") && i + 1 < argc) {
+      boost::filesystem::path directory =
+        boost::filesystem::path(argv[++i]) / "share" / "pluginlib";
+      boost::system::error_code error;
+      boost::filesystem::create_directories(directory, error);
+      if (error) {
+        std::cerr << "Unable to create " << directory.string() << ": " << error.message() <<
+          std::endl;
+        return 1;
+      }
+      output = (directory / "plugin_index").string();
+    } else {
+      printUsage(argv[0]);
+      return 0 == std::strcmp(argv[i], "--help") || 0 == std::strcmp(argv[i], "-h") ? 0 : 1;
+    }
+  }
+
+  pluginlib::WorkspaceIndex::ConstPtr index = pluginlib::WorkspaceIndex::build();
+  if (output.empty()) {
+    return index->write(std::cout) ? 0 : 1;
+  }
+
+  // Replace the index atomically, since running processes may be reading it
+  std::string temporary = output + ".tmp";
+  {
+    std::ofstream file(temporary.c_str(), std::ios::out | std::ios::trunc);
+    if (!index->write(file)) {
+      std::cerr << "Unable to write " << temporary << std::endl;
+      return 1;
+    }
+  }
+  boost::system::error_code error;
+  boost::filesystem::rename(temporary, output, error);
+  if (error) {
+    std::cerr << "Unable to write " << output << ": " << error.message() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <pluginlib/class_loader.hpp>
+
+#include "./test_base.h"
+
+// Allocations made by the current thread while counting, so that the loader's own threads and
+// gtest do not interfere.
+static thread_local bool g_counting = false;
+static thread_local size_t g_allocations = 0;
+
+void * operator new(size_t size)
+{
+  if (g_counting) {
+    ++g_allocations;
+  }
+  void * ptr = std::malloc(size > 0 ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+/// Return the number of heap allocations a function makes.
+template<class Function>
+size_t countAllocations(const Function & function)
+{
+  g_allocations = 0;
+  g_counting = true;
+  function();
+  g_counting = false;
+  return g_allocations;
+}
+
+/// Results of the queries, checked once counting stopped since failures allocate.
+struct Metadata
+{
+  boost::string_view class_type;
+  boost::string_view package;
+  boost::string_view description;
+  boost::string_view manifest_path;
+  boost::string_view name;
+  boost::string_view unknown_class_type;
+  bool literal_available;
+  bool string_available;
+  bool unknown_available;
+};
+
+void queryMetadata(pluginlib::ClassLoader<test_base::Fubar> & test_loader)
+{
+  std::string lookup_name("pluginlib/foo");
+  Metadata metadata;
+  size_t allocations = countAllocations([&]() {
+        metadata.class_type = test_loader.getClassTypeView("pluginlib/foo");
+        metadata.package = test_loader.getClassPackageView(lookup_name);
+        metadata.description = test_loader.getClassDescriptionView(lookup_name);
+        metadata.manifest_path = test_loader.getPluginManifestPathView(lookup_name);
+        metadata.name = test_loader.getNameView(lookup_name);
+        metadata.unknown_class_type = test_loader.getClassTypeView("pluginlib/nonexistent");
+        metadata.literal_available = test_loader.isClassAvailable("pluginlib/foo");
+        metadata.string_available = test_loader.isClassAvailable(lookup_name);
+        metadata.unknown_available =
+          test_loader.isClassAvailable(boost::string_view("pluginlib/nonexistent"));
+      });
+  EXPECT_EQ(0u, allocations);
+  EXPECT_EQ("test_plugins::Foo", metadata.class_type);
+  EXPECT_EQ("pluginlib", metadata.package);
+  EXPECT_EQ("This is a foo plugin.", metadata.description);
+  EXPECT_EQ(test_loader.getPluginManifestPath(lookup_name), metadata.manifest_path);
+  EXPECT_EQ("foo", metadata.name);
+  EXPECT_TRUE(metadata.unknown_class_type.empty());
+  EXPECT_TRUE(metadata.literal_available);
+  EXPECT_TRUE(metadata.string_available);
+  EXPECT_FALSE(metadata.unknown_available);
+}
+
+TEST(PluginlibAllocationTest, metadataQueries) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  // The first request reads the description from the plugin manifest
+  ASSERT_EQ("This is a foo plugin.", test_loader.getClassDescriptionView("pluginlib/foo"));
+
+  queryMetadata(test_loader);
+  test_loader.freeze();
+  queryMetadata(test_loader);
+}
+
+TEST(PluginlibAllocationTest, viewsOutliveUnchangedRefreshes) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  boost::string_view class_type = test_loader.getClassTypeView("pluginlib/foo");
+  // No plugin manifest changed, the view still points into the loader's classes
+  test_loader.refreshDeclaredClasses();
+  EXPECT_EQ(test_loader.getClassType("pluginlib/foo"), class_type);
+  EXPECT_EQ('\0', class_type.data()[class_type.size()]);
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
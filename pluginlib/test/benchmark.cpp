@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Benchmarks for the discovery code paths. Not run as part of the tests:
+//   make pluginlib_benchmark && ./pluginlib_benchmark [plugin library...]
+// The plugin libraries given are loaded from a cold and a warmed page cache.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <pluginlib/class_desc.hpp>
+#include <pluginlib/class_desc_store.hpp>
+#include <pluginlib/frozen_class_table.hpp>
+#include <pluginlib/library_prefetcher.hpp>
+#include <pluginlib/mapped_file.hpp>
+#include <pluginlib/plugin_xml_parser.hpp>
+#include <tinyxml2.h>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if __cplusplus >= 201103L
+// Bytes currently allocated with the global operator new, which keeps each block's size in
+// front of it, to weigh data structures.
+static size_t g_heap_bytes = 0;
+static const size_t kBlockHeader = alignof(std::max_align_t);
+
+void * operator new(size_t size)
+{
+  void * block = std::malloc(size + kBlockHeader);
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  *static_cast<size_t *>(block) = size;
+  g_heap_bytes += size;
+  return static_cast<char *>(block) + kBlockHeader;
+}
+
+void operator delete(void * ptr) noexcept
+{
+  if (ptr) {
+    void * block = static_cast<char *>(ptr) - kBlockHeader;
+    g_heap_bytes -= *static_cast<size_t *>(block);
+    std::free(block);
+  }
+}
+#endif
+
+namespace
+{
+
+class Stopwatch
+{
+public:
+  Stopwatch()
+  : start_(boost::posix_time::microsec_clock::universal_time()) {}
+
+  double seconds() const
+  {
+    return (boost::posix_time::microsec_clock::universal_time() - start_).total_microseconds() /
+           1e6;
+  }
+
+private:
+  boost::posix_time::ptime start_;
+};
+
+/// Write a plugin description file declaring class_count classes, a tenth of them of base_class.
+std::string writeManifest(
+  const boost::filesystem::path & directory, size_t class_count, const std::string & base_class)
+{
+  std::ostringstream xml;
+  xml << "<?xml version=\"1.0\"?>\n<class_libraries>\n";
+  for (size_t i = 0; i < class_count; ++i) {
+    if (0 == i % 10) {
+      xml << "  <library path=\"lib/libbenchmark_plugins_" << i / 10 << "\">\n";
+    }
+    xml << "    <class name=\"benchmark/plugin_" << i << "\" type=\"benchmark::Plugin" << i <<
+      "\"\n      base_class_type=\"" << (0 == i % 10 ? base_class : "benchmark::Other") <<
+      "\">\n      <description>Plugin number " << i << " for the benchmark.</description>\n" <<
+      "    </class>\n";
+    if (9 == i % 10 || i + 1 == class_count) {
+      xml << "  </library>\n";
+    }
+  }
+  xml << "</class_libraries>\n";
+
+  std::ostringstream name;
+  name << "plugins_" << class_count << ".xml";
+  std::string path = (directory / name.str()).string();
+  std::ofstream(path.c_str()) << xml.str();
+  return path;
+}
+
+/// What ClassLoader::processSingleXMLPluginFileWithTinyXML() does, minus the package lookup.
+size_t parseWithTinyXML(const std::string & path, const std::string & base_class)
+{
+  std::vector<pluginlib::ClassDesc> classes;
+  tinyxml2::XMLDocument document;
+  document.LoadFile(path.c_str());
+  tinyxml2::XMLElement * library = document.RootElement()->FirstChildElement("library");
+  for (; library; library = library->NextSiblingElement("library")) {
+    std::string library_path = library->Attribute("path");
+    tinyxml2::XMLElement * class_element = library->FirstChildElement("class");
+    for (; class_element; class_element = class_element->NextSiblingElement("class")) {
+      std::string derived_class = class_element->Attribute("type");
+      std::string base_class_type = class_element->Attribute("base_class_type");
+      std::string lookup_name = class_element->Attribute("name");
+      if (base_class_type == base_class) {
+        tinyxml2::XMLElement * description = class_element->FirstChildElement("description");
+        std::string description_str = description && description->GetText() ?
+          description->GetText() : "";
+        classes.push_back(pluginlib::ClassDesc(lookup_name, derived_class, base_class_type, "",
+          description_str, library_path, path));
+      }
+    }
+  }
+  return classes.size();
+}
+
+/// What ClassLoader::processSingleXMLPluginFile() does, minus the package lookup.
+size_t parseWithPluginXMLParser(const std::string & path, const std::string & base_class)
+{
+  std::vector<pluginlib::ClassDesc> classes;
+  pluginlib::MappedFile file(path);
+  std::vector<pluginlib::PluginXMLClass> declarations;
+  if (!pluginlib::PluginXMLParser::parseClasses(file.data(), file.size(), declarations)) {
+    return 0;
+  }
+  for (size_t i = 0; i < declarations.size(); ++i) {
+    const pluginlib::PluginXMLClass & declaration = declarations[i];
+    if (declaration.base_class_type != base_class) {
+      continue;
+    }
+    classes.push_back(pluginlib::ClassDesc(
+        std::string(declaration.lookup_name.data(), declaration.lookup_name.size()),
+        std::string(declaration.type.data(), declaration.type.size()), base_class, "",
+        std::string(declaration.description.data(), declaration.description.size()),
+        std::string(declaration.library_path.data(), declaration.library_path.size()), path));
+  }
+  return classes.size();
+}
+
+void benchmarkManifestParsing(const boost::filesystem::path & directory)
+{
+  const std::string base_class = "benchmark::Base";
+  const size_t sizes[] = {10, 100, 1000, 10000};
+  std::printf("Plugin description parsing\n");
+  std::printf("%10s %12s %14s %14s %9s\n", "classes", "bytes", "tinyxml2 MB/s", "parser MB/s",
+    "speedup");
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    std::string path = writeManifest(directory, sizes[i], base_class);
+    size_t bytes = static_cast<size_t>(boost::filesystem::file_size(path));
+    size_t iterations = 1 + 2000000 / bytes;
+
+    Stopwatch tinyxml_watch;
+    size_t tinyxml_classes = 0;
+    for (size_t j = 0; j < iterations; ++j) {
+      tinyxml_classes += parseWithTinyXML(path, base_class);
+    }
+    double tinyxml_seconds = tinyxml_watch.seconds();
+
+    Stopwatch parser_watch;
+    size_t parser_classes = 0;
+    for (size_t j = 0; j < iterations; ++j) {
+      parser_classes += parseWithPluginXMLParser(path, base_class);
+    }
+    double parser_seconds = parser_watch.seconds();
+
+    if (tinyxml_classes != parser_classes) {
+      std::printf("  results differ for %u classes\n", static_cast<unsigned int>(sizes[i]));
+    }
+    double megabytes = static_cast<double>(bytes) * iterations / 1e6;
+    std::printf("%10u %12u %14.1f %14.1f %8.1fx\n", static_cast<unsigned int>(sizes[i]),
+      static_cast<unsigned int>(bytes), megabytes / tinyxml_seconds, megabytes / parser_seconds,
+      tinyxml_seconds / parser_seconds);
+  }
+}
+
+/// Write manifest_count plugin description files, one in twenty of them declaring base_class.
+std::vector<std::string> writeWorkspace(
+  const boost::filesystem::path & directory, size_t manifest_count, const std::string & base_class)
+{
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < manifest_count; ++i) {
+    std::ostringstream name;
+    name << "package_" << i;
+    boost::filesystem::path package_directory = directory / name.str();
+    boost::filesystem::create_directories(package_directory);
+    paths.push_back(writeManifest(package_directory, 20,
+      0 == i % 20 ? base_class : std::string("benchmark::Unrelated")));
+  }
+  return paths;
+}
+
+void benchmarkBaseClassPrefilter(const boost::filesystem::path & directory)
+{
+  const std::string base_class = "benchmark::Base";
+  const size_t manifest_count = 2000;
+  std::vector<std::string> paths = writeWorkspace(directory, manifest_count, base_class);
+  const size_t iterations = 10;
+
+  Stopwatch parse_watch;
+  size_t parsed_classes = 0;
+  for (size_t j = 0; j < iterations; ++j) {
+    for (size_t i = 0; i < paths.size(); ++i) {
+      parsed_classes += parseWithPluginXMLParser(paths[i], base_class);
+    }
+  }
+  double parse_seconds = parse_watch.seconds();
+
+  Stopwatch prefilter_watch;
+  size_t prefiltered_classes = 0;
+  size_t skipped = 0;
+  for (size_t j = 0; j < iterations; ++j) {
+    for (size_t i = 0; i < paths.size(); ++i) {
+      {
+        pluginlib::MappedFile file(paths[i]);
+        if (!pluginlib::PluginXMLParser::mayDeclareBaseClass(file.data(), file.size(),
+          base_class))
+        {
+          ++skipped;
+          continue;
+        }
+      }
+      prefiltered_classes += parseWithPluginXMLParser(paths[i], base_class);
+    }
+  }
+  double prefilter_seconds = prefilter_watch.seconds();
+
+  if (parsed_classes != prefiltered_classes) {
+    std::printf("  results differ\n");
+  }
+  std::printf("\nBase class prefilter, %u manifests\n", static_cast<unsigned int>(manifest_count));
+  std::printf("%10s %14s %14s %9s\n", "skipped", "parse ms", "prefilter ms", "speedup");
+  std::printf("%9.1f%% %14.2f %14.2f %8.1fx\n",
+    100.0 * skipped / (manifest_count * iterations), 1e3 * parse_seconds / iterations,
+    1e3 * prefilter_seconds / iterations, parse_seconds / prefilter_seconds);
+}
+
+/// Look up the names round robin, returning the mean time per lookup in nanoseconds.
+template<class Name, class Lookup>
+double timeLookups(const std::vector<Name> & lookup_names, const Lookup & lookup)
+{
+  const size_t lookups = 2000000;
+  size_t found = 0;
+  Stopwatch watch;
+  for (size_t i = 0; i < lookups; ++i) {
+    found += lookup(lookup_names[i % lookup_names.size()]);
+  }
+  double seconds = watch.seconds();
+  if (found != lookups) {
+    std::printf("  lookups failed\n");
+  }
+  return 1e9 * seconds / lookups;
+}
+
+struct MapLookup
+{
+  explicit MapLookup(const std::map<std::string, pluginlib::ClassDesc> & classes)
+  : classes(classes) {}
+
+  size_t operator()(const std::string & lookup_name) const
+  {
+    return classes.find(lookup_name) != classes.end() ? 1 : 0;
+  }
+
+  const std::map<std::string, pluginlib::ClassDesc> & classes;
+};
+
+struct FrozenLookup
+{
+  explicit FrozenLookup(const pluginlib::FrozenClassTable & table)
+  : table(table) {}
+
+  size_t operator()(const std::string & lookup_name) const
+  {
+    return table.find(lookup_name).isValid() ? 1 : 0;
+  }
+
+  const pluginlib::FrozenClassTable & table;
+};
+
+/// Looks up keys hashed beforehand, like those of the _plugin literal.
+struct FrozenKeyLookup
+{
+  explicit FrozenKeyLookup(const pluginlib::FrozenClassTable & table)
+  : table(table) {}
+
+  size_t operator()(const pluginlib::LookupKey & key) const
+  {
+    return table.find(key).isValid() ? 1 : 0;
+  }
+
+  const pluginlib::FrozenClassTable & table;
+};
+
+void benchmarkClassLookup()
+{
+  const size_t sizes[] = {10, 1000, 100000};
+  std::printf("\nClass lookup by name\n");
+  std::printf("%10s %12s %12s %12s %12s\n", "classes", "map ns", "frozen ns", "key ns",
+    "build ms");
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    std::map<std::string, pluginlib::ClassDesc> classes;
+    std::vector<std::string> lookup_names;
+    for (size_t j = 0; j < sizes[i]; ++j) {
+      std::ostringstream lookup_name;
+      lookup_name << "benchmark/plugin_" << j;
+      lookup_names.push_back(lookup_name.str());
+      classes.insert(std::make_pair(lookup_name.str(), pluginlib::ClassDesc(lookup_name.str(),
+        "benchmark::Plugin", "benchmark::Base", "benchmark", "", "lib/libbenchmark", "")));
+    }
+    // Visit the names in an order unrelated to their layout in either table
+    for (size_t j = lookup_names.size(); j > 1; --j) {
+      std::swap(lookup_names[j - 1], lookup_names[(j * 2654435761u) % j]);
+    }
+
+    Stopwatch build_watch;
+    pluginlib::FrozenClassTable table(
+      pluginlib::ClassDescTable::ConstPtr(new pluginlib::ClassDescTable(classes)));
+    double build_seconds = build_watch.seconds();
+    double map_ns = timeLookups(lookup_names, MapLookup(classes));
+    double frozen_ns = timeLookups(lookup_names, FrozenLookup(table));
+    std::vector<pluginlib::LookupKey> keys;
+    for (size_t j = 0; j < lookup_names.size(); ++j) {
+      keys.push_back(pluginlib::LookupKey(lookup_names[j]));
+    }
+    double key_ns = timeLookups(keys, FrozenKeyLookup(table));
+    std::printf("%10u %12.1f %12.1f %12.1f %12.2f\n", static_cast<unsigned int>(sizes[i]),
+      map_ns, frozen_ns, key_ns, 1e3 * build_seconds);
+  }
+}
+
+#if __cplusplus >= 201103L
+/// Look for the classes of a library in every description, returning the time per class in ns.
+template<class Scan>
+double timeScans(size_t class_count, const Scan & scan)
+{
+  const size_t scans = 200;
+  size_t found = 0;
+  Stopwatch watch;
+  for (size_t i = 0; i < scans; ++i) {
+    found += scan("lib/libpackage_7_plugins");
+  }
+  double seconds = watch.seconds();
+  if (found != scans * 10) {
+    std::printf("  scan failed\n");
+  }
+  return 1e9 * seconds / (scans * class_count);
+}
+
+struct MapScan
+{
+  explicit MapScan(const std::map<std::string, pluginlib::ClassDesc> & classes)
+  : classes(classes) {}
+
+  size_t operator()(const char * library_name) const
+  {
+    size_t found = 0;
+    for (std::map<std::string, pluginlib::ClassDesc>::const_iterator it = classes.begin();
+      it != classes.end(); ++it)
+    {
+      found += it->second.library_name_ == library_name ? 1 : 0;
+    }
+    return found;
+  }
+
+  const std::map<std::string, pluginlib::ClassDesc> & classes;
+};
+
+struct TableScan
+{
+  explicit TableScan(const pluginlib::ClassDescTable & classes)
+  : classes(classes) {}
+
+  size_t operator()(const char * library_name) const
+  {
+    size_t found = 0;
+    for (size_t i = 0; i < classes.size(); ++i) {
+      found += 0 == std::strcmp(classes[i].getLibraryName(), library_name) ? 1 : 0;
+    }
+    return found;
+  }
+
+  const pluginlib::ClassDescTable & classes;
+};
+
+void benchmarkClassStorage()
+{
+  // Ten classes per package, of one base class, each with a description of its own
+  const size_t sizes[] = {100, 2000, 20000};
+  std::printf("\nClass description storage\n");
+  std::printf("%10s %14s %14s %14s %10s %12s %12s\n", "classes", "map B/class",
+    "store B/class", "lazy B/class", "ratio", "map scan ns", "store scan ns");
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    std::vector<pluginlib::ClassDesc> descs;
+    for (size_t j = 0; j < sizes[i]; ++j) {
+      std::ostringstream package, lookup_name, type, description;
+      package << "package_" << j / 10;
+      lookup_name << package.str() << "/local_planner_" << j % 10;
+      type << package.str() << "::LocalPlanner" << j % 10;
+      description << "Local planner " << j % 10 << " of " << package.str() <<
+        ", scoring trajectories by their distance to the global path.";
+      descs.push_back(pluginlib::ClassDesc(lookup_name.str(), type.str(),
+        "nav_core::BaseLocalPlanner", package.str(), description.str(),
+        "lib/lib" + package.str() + "_plugins",
+        "/opt/ros/noetic/share/" + package.str() + "/plugins.xml"));
+    }
+
+    size_t heap_bytes = g_heap_bytes;
+    std::map<std::string, pluginlib::ClassDesc> * map = new std::map<std::string,
+        pluginlib::ClassDesc>();
+    for (size_t j = 0; j < descs.size(); ++j) {
+      map->insert(std::make_pair(descs[j].lookup_name_, descs[j]));
+    }
+    size_t map_bytes = g_heap_bytes - heap_bytes;
+
+    heap_bytes = g_heap_bytes;
+    pluginlib::ClassDescTable * table = new pluginlib::ClassDescTable(*map);
+    size_t table_bytes = g_heap_bytes - heap_bytes;
+
+    // As parsed, with the descriptions left in the manifests
+    std::map<std::string, pluginlib::ClassDesc> deferred(*map);
+    for (std::map<std::string, pluginlib::ClassDesc>::iterator it = deferred.begin();
+      it != deferred.end(); ++it)
+    {
+      it->second.deferDescription(100, it->second.description_.size());
+    }
+    heap_bytes = g_heap_bytes;
+    pluginlib::ClassDescTable * deferred_table = new pluginlib::ClassDescTable(deferred);
+    size_t deferred_table_bytes = g_heap_bytes - heap_bytes;
+    delete deferred_table;
+
+    double map_ns = timeScans(sizes[i], MapScan(*map));
+    double table_ns = timeScans(sizes[i], TableScan(*table));
+    std::printf("%10u %14.1f %14.1f %14.1f %9.1fx %12.2f %12.2f\n",
+      static_cast<unsigned int>(sizes[i]), static_cast<double>(map_bytes) / sizes[i],
+      static_cast<double>(table_bytes) / sizes[i],
+      static_cast<double>(deferred_table_bytes) / sizes[i],
+      static_cast<double>(map_bytes) / deferred_table_bytes, map_ns, table_ns);
+    delete table;
+    delete map;
+  }
+}
+#endif
+
+#ifdef __linux__
+/// Load a library in a child process, which starts with nothing of it mapped, in seconds.
+double timeLibraryLoad(const std::string & path)
+{
+  int fds[2];
+  if (0 != pipe(fds)) {
+    return -1.0;
+  }
+  pid_t pid = fork();
+  if (0 == pid) {
+    Stopwatch watch;
+    double seconds = dlopen(path.c_str(), RTLD_NOW) ? watch.seconds() : -1.0;
+    ssize_t written = write(fds[1], &seconds, sizeof(seconds));
+    _exit(static_cast<ssize_t>(sizeof(seconds)) == written ? 0 : 1);
+  }
+  double seconds = -1.0;
+  ssize_t bytes_read = pid < 0 ? 0 : read(fds[0], &seconds, sizeof(seconds));
+  if (static_cast<ssize_t>(sizeof(seconds)) != bytes_read) {
+    seconds = -1.0;
+  }
+  if (pid > 0) {
+    waitpid(pid, NULL, 0);
+  }
+  close(fds[0]);
+  close(fds[1]);
+  return seconds;
+}
+
+/// Drop the files from the page cache, as far as no process maps them.
+void evictFromPageCache(const std::vector<std::string> & paths)
+{
+  for (size_t i = 0; i < paths.size(); ++i) {
+    int fd = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+  }
+}
+
+void benchmarkLibraryPrefetching(const std::vector<std::string> & library_paths)
+{
+  std::printf("\nLibrary loading from a cold and a prefetched page cache\n");
+  if (library_paths.empty()) {
+    std::printf("  pass plugin library paths to measure\n");
+    return;
+  }
+  std::printf("%-40s %6s %10s %10s %9s\n", "library", "files", "cold ms", "warm ms", "speedup");
+  const size_t runs = 5;
+  for (size_t i = 0; i < library_paths.size(); ++i) {
+    std::vector<std::string> library(1, library_paths[i]);
+    pluginlib::LibraryPrefetcher walker;
+    walker.prefetch(library);
+    std::vector<std::string> files = walker.getPrefetched();
+
+    double cold_seconds = 0.0;
+    double warm_seconds = 0.0;
+    for (size_t run = 0; run < runs; ++run) {
+      evictFromPageCache(files);
+      cold_seconds += timeLibraryLoad(library_paths[i]);
+      evictFromPageCache(files);
+      pluginlib::LibraryPrefetcher prefetcher;
+      prefetcher.prefetch(library);
+      // The time a loader spends on other work between prefetching and loading
+      usleep(200000);
+      warm_seconds += timeLibraryLoad(library_paths[i]);
+    }
+    std::string name = library_paths[i].substr(library_paths[i].rfind('/') + 1);
+    if (cold_seconds < 0.0 || warm_seconds < 0.0) {
+      std::printf("%-40s failed to load\n", name.c_str());
+      continue;
+    }
+    std::printf("%-40s %6u %10.2f %10.2f %8.1fx\n", name.c_str(),
+      static_cast<unsigned int>(files.size()), cold_seconds / runs * 1e3,
+      warm_seconds / runs * 1e3, cold_seconds / warm_seconds);
+  }
+}
+#endif
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  boost::filesystem::path directory =
+    boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(directory);
+
+  benchmarkManifestParsing(directory);
+  benchmarkBaseClassPrefilter(directory);
+  benchmarkClassLookup();
+#if __cplusplus >= 201103L
+  benchmarkClassStorage();
+#endif
+#ifdef __linux__
+  benchmarkLibraryPrefetching(std::vector<std::string>(argv + 1, argv + argc));
+#else
+  (void)argc;
+  (void)argv;
+#endif
+
+  boost::filesystem::remove_all(directory);
+  return 0;
+}
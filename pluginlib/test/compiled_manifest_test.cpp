@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <pluginlib/class_loader.hpp>
+#include <pluginlib/compiled_manifest.hpp>
+
+#include "./test_base.h"
+
+// This test links the table pluginlib_compile_manifests() generated for test/test_plugins.xml.
+
+TEST(PluginlibCompiledManifestTest, registeredTable) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  std::vector<std::string> plugin_xml_paths = test_loader.getPluginXmlPaths();
+  const pluginlib::CompiledManifest * compiled = NULL;
+  for (size_t i = 0; i < plugin_xml_paths.size() && !compiled; ++i) {
+    compiled = pluginlib::CompiledManifestRegistry::instance().find(plugin_xml_paths[i]);
+  }
+  ASSERT_TRUE(NULL != compiled);
+  EXPECT_EQ(std::string("pluginlib"), compiled->package);
+  EXPECT_EQ(std::string("test/test_plugins.xml"), compiled->relative_path);
+  EXPECT_EQ(3u, compiled->class_count);
+
+  EXPECT_TRUE(NULL == pluginlib::CompiledManifestRegistry::instance().find("/test_plugins.xml"));
+  EXPECT_TRUE(NULL == pluginlib::CompiledManifestRegistry::instance().find(
+      "/not_pluginlib/test/test_plugins.xml"));
+}
+
+TEST(PluginlibCompiledManifestTest, classesFromTable) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  EXPECT_TRUE(test_loader.isClassAvailable("pluginlib/foo"));
+  EXPECT_TRUE(test_loader.isClassAvailable("pluginlib/bar"));
+  EXPECT_EQ("This is a foo plugin.", test_loader.getClassDescription("pluginlib/foo"));
+  EXPECT_EQ("test_plugins::Bar", test_loader.getClassType("pluginlib/bar"));
+  EXPECT_EQ("pluginlib", test_loader.getClassPackage("pluginlib/bar"));
+
+  boost::shared_ptr<test_base::Fubar> foo = test_loader.createInstance("pluginlib/foo");
+  foo->initialize(10.0);
+  EXPECT_EQ(100.0, foo->result());
+
+  pluginlib::ClassLoader<test_base::Fubar> misspelled_loader("pluginlib", "test_base::Fuba");
+  EXPECT_TRUE(misspelled_loader.getDeclaredClasses().empty());
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -29,7 +29,22 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
 #include <pluginlib/class_loader.hpp>
+#include <pluginlib/directory_listing_cache.hpp>
+#include <pluginlib/library_path_cache.hpp>
+#include <pluginlib/library_prefetcher.hpp>
+#include <pluginlib/plugin_xml_parser.hpp>
+#include <pluginlib/resolution_context.hpp>
+#include <pluginlib/workspace_index.hpp>
 
 #include "./test_base.h"
 
@@ -119,6 +134,96 @@ TEST(PluginlibTest, createManagedInstanceAndUnloadLibrary) {
   ROS_INFO("Done.");
 }
 
+TEST(PluginlibTest, pluginHandle) {
+  pluginlib::ClassLoader<test_base::Fubar> pl("pluginlib", "test_base::Fubar");
+
+  EXPECT_FALSE(pluginlib::PluginHandle<test_base::Fubar>().isValid());
+  EXPECT_THROW(pluginlib::PluginHandle<test_base::Fubar>().createInstance(),
+    pluginlib::CreateClassException);
+  EXPECT_THROW(pl.getPluginHandle("pluginlib/nonexistent"), pluginlib::LibraryLoadException);
+  EXPECT_THROW(pl.getPluginHandle("pluginlib/none"), pluginlib::CreateClassException);
+
+  {
+    pluginlib::PluginHandle<test_base::Fubar> handle = pl.getPluginHandle("pluginlib/foo");
+    ASSERT_TRUE(handle.isValid());
+    EXPECT_EQ("pluginlib/foo", handle.getLookupName());
+    EXPECT_EQ(pl.getClassType("pluginlib/foo"), handle.getClassType());
+    EXPECT_EQ(pl.getClassLibraryPath("pluginlib/foo"), handle.getLibraryPath());
+    EXPECT_TRUE(pl.isClassLoaded("pluginlib/foo"));
+
+    boost::shared_ptr<test_base::Fubar> foo = handle.createInstance();
+    foo->initialize(10.0);
+    EXPECT_EQ(100.0, foo->result());
+
+    // The handle keeps the library loaded, and its release carries out the unload
+    EXPECT_LT(0, pl.unloadLibraryForClass("pluginlib/foo"));
+    EXPECT_TRUE(pl.isClassLoaded("pluginlib/foo"));
+    foo = handle.createInstance();
+    EXPECT_TRUE(foo.get() != NULL);
+    foo.reset();
+  }
+  EXPECT_FALSE(pl.isClassLoaded("pluginlib/foo"));
+
+  // Loading the library again takes the deferred unload back
+  {
+    pluginlib::PluginHandle<test_base::Fubar> handle = pl.getPluginHandle("pluginlib/foo");
+    test_base::Fubar * unmanaged = handle.createUnmanagedInstance();
+    unmanaged->initialize(2.0);
+    EXPECT_EQ(4.0, unmanaged->result());
+    delete unmanaged;
+    EXPECT_LT(0, pl.unloadLibraryForClass("pluginlib/foo"));
+    pl.loadLibraryForClass("pluginlib/foo");
+  }
+  EXPECT_TRUE(pl.isClassLoaded("pluginlib/foo"));
+  EXPECT_EQ(0, pl.unloadLibraryForClass("pluginlib/foo"));
+}
+
+TEST(PluginlibTest, asyncLoad) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  boost::shared_future<void> foo_load = test_loader.loadLibraryForClassAsync("pluginlib/foo");
+  boost::shared_future<void> bar_load = test_loader.loadLibraryForClassAsync("pluginlib/bar");
+  EXPECT_NO_THROW(foo_load.get());
+  EXPECT_NO_THROW(bar_load.get());
+  EXPECT_TRUE(test_loader.isClassLoaded("pluginlib/foo"));
+  EXPECT_TRUE(test_loader.isClassLoaded("pluginlib/bar"));
+  EXPECT_THROW(test_loader.loadLibraryForClassAsync("pluginlib/nonexistent").get(),
+    pluginlib::LibraryLoadException);
+
+  // On an executor of the caller's, which may be destroyed before the loader
+  pluginlib::Executor::Ptr executor(new pluginlib::ThreadPoolExecutor(2));
+  boost::shared_future<boost::shared_ptr<test_base::Fubar> > instance =
+    test_loader.createInstanceAsync("pluginlib/foo", executor);
+  executor.reset();
+  boost::shared_ptr<test_base::Fubar> foo = instance.get();
+  ASSERT_TRUE(foo.get() != NULL);
+  foo->initialize(10.0);
+  EXPECT_EQ(100.0, foo->result());
+  EXPECT_THROW(test_loader.createInstanceAsync("pluginlib/nonexistent").get(),
+    pluginlib::LibraryLoadException);
+}
+
+TEST(PluginlibTest, libraryPrefetcher) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  std::string library_path = test_loader.getClassLibraryPath("pluginlib/foo");
+  ASSERT_FALSE(library_path.empty());
+
+  pluginlib::ElfDynamicInfo info;
+#ifdef __linux__
+  EXPECT_TRUE(pluginlib::LibraryPrefetcher::readDynamicInfo(library_path, info));
+  EXPECT_FALSE(info.needed.empty());
+#endif
+  EXPECT_FALSE(pluginlib::LibraryPrefetcher::readDynamicInfo(
+      test_loader.getPluginManifestPath("pluginlib/foo"), info));
+
+  pluginlib::LibraryPrefetcher prefetcher;
+  EXPECT_EQ(0u, prefetcher.prefetch(
+      std::vector<std::string>(1, "/pluginlib_nonexistent/libplugins.so")));
+  EXPECT_TRUE(prefetcher.getPrefetched().empty());
+
+  EXPECT_NO_THROW(test_loader.prefetchLibraries().get());
+  EXPECT_NO_THROW(test_loader.createInstance("pluginlib/foo"));
+}
+
 TEST(PluginlibTest, brokenXML) {
   try {
     pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar",
@@ -132,6 +237,643 @@ TEST(PluginlibTest, brokenXML) {
   ADD_FAILURE() << "Didn't throw exception as expected";
 }
 
+TEST(PluginlibTest, indexCache) {
+  boost::filesystem::path cache_dir =
+    boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  setenv("PLUGINLIB_CACHE_DIR", cache_dir.string().c_str(), 1);
+
+  std::vector<std::string> parsed_classes;
+  {
+    pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+    parsed_classes = test_loader.getDeclaredClasses();
+  }
+  pluginlib::PluginIndexCache index_cache("pluginlib", "plugin");
+  EXPECT_TRUE(boost::filesystem::exists(index_cache.getPath()));
+
+  {
+    pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+    EXPECT_EQ(parsed_classes, test_loader.getDeclaredClasses());
+    EXPECT_EQ("This is a foo plugin.", test_loader.getClassDescription("pluginlib/foo"));
+    boost::shared_ptr<test_base::Fubar> foo = test_loader.createInstance("pluginlib/foo");
+    foo->initialize(10.0);
+    EXPECT_EQ(100.0, foo->result());
+  }
+
+  // A manifest that failed to parse is not recorded as declaring nothing
+  {
+    pluginlib::ClassLoader<test_base::Fubar> broken_loader("pluginlib", "test_base::Fubar",
+      "plugin_test");
+    std::vector<std::string> plugin_xml_paths = broken_loader.getPluginXmlPaths();
+    std::vector<pluginlib::ManifestStamp> stamps;
+    for (size_t i = 0; i < plugin_xml_paths.size(); ++i) {
+      stamps.push_back(pluginlib::ManifestStamp::of(plugin_xml_paths[i]));
+    }
+    std::vector<pluginlib::PluginManifest> manifests;
+    if (pluginlib::PluginIndexCache("pluginlib", "plugin_test").load(plugin_xml_paths, stamps,
+      manifests))
+    {
+      for (size_t i = 0; i < manifests.size(); ++i) {
+        EXPECT_FALSE(manifests[i].isComplete("test_base::Fubar"));
+      }
+    }
+  }
+
+  unsetenv("PLUGINLIB_CACHE_DIR");
+  boost::filesystem::remove_all(cache_dir);
+}
+
+TEST(PluginlibTest, sharedDiscovery) {
+  {
+    pluginlib::ClassLoader<test_base::Fubar> first_loader("pluginlib", "test_base::Fubar");
+    pluginlib::DiscoveryRegistry::EntryPtr entry =
+      pluginlib::DiscoveryRegistry::instance().acquire(
+      "pluginlib", "plugin", pluginlib::getDefaultDiscoveryBackend());
+    {
+      boost::mutex::scoped_lock lock(entry->mutex);
+      EXPECT_TRUE(entry->crawled);
+      ASSERT_TRUE(entry->catalog);
+      EXPECT_TRUE(entry->catalog->getClasses("test_base::Fubar")->find("pluginlib/foo").isValid());
+    }
+
+    pluginlib::ClassLoader<test_base::Fubar> second_loader("pluginlib", "test_base::Fubar");
+    EXPECT_EQ(first_loader.getDeclaredClasses(), second_loader.getDeclaredClasses());
+    EXPECT_EQ(first_loader.getPluginXmlPaths(), second_loader.getPluginXmlPaths());
+    boost::shared_ptr<test_base::Fubar> foo = second_loader.createInstance("pluginlib/foo");
+    EXPECT_TRUE(second_loader.isClassLoaded("pluginlib/foo"));
+
+    // Loaders finding what they need do not wait for one at work on the entry
+    boost::mutex::scoped_lock work_lock(entry->work_mutex);
+    pluginlib::ClassLoader<test_base::Fubar> third_loader("pluginlib", "test_base::Fubar");
+    EXPECT_EQ(first_loader.getDeclaredClasses(), third_loader.getDeclaredClasses());
+  }
+
+  // Entries are released with the last loader using them
+  pluginlib::DiscoveryRegistry::EntryPtr entry = pluginlib::DiscoveryRegistry::instance().acquire(
+    "pluginlib", "plugin", pluginlib::getDefaultDiscoveryBackend());
+  boost::mutex::scoped_lock lock(entry->mutex);
+  EXPECT_FALSE(entry->crawled);
+}
+
+TEST(PluginlibTest, parallelDiscovery) {
+  setenv("PLUGINLIB_CACHE_DIR", "", 1);
+  pluginlib::ClassLoader<test_base::Fubar> crawled_loader("pluginlib", "test_base::Fubar");
+  std::vector<std::string> crawled_paths = crawled_loader.getPluginXmlPaths();
+  std::vector<std::string> plugin_xml_paths;
+  for (int i = 0; i < 16; ++i) {
+    plugin_xml_paths.insert(plugin_xml_paths.end(), crawled_paths.begin(), crawled_paths.end());
+  }
+
+  setenv("PLUGINLIB_DISCOVERY_THREADS", "1", 1);
+  pluginlib::ClassLoader<test_base::Fubar> serial_loader("pluginlib", "test_base::Fubar",
+    "plugin", plugin_xml_paths);
+  setenv("PLUGINLIB_DISCOVERY_THREADS", "4", 1);
+  pluginlib::ClassLoader<test_base::Fubar> parallel_loader("pluginlib", "test_base::Fubar",
+    "plugin", plugin_xml_paths);
+  unsetenv("PLUGINLIB_DISCOVERY_THREADS");
+  unsetenv("PLUGINLIB_CACHE_DIR");
+
+  EXPECT_EQ(crawled_loader.getDeclaredClasses(), serial_loader.getDeclaredClasses());
+  EXPECT_EQ(serial_loader.getDeclaredClasses(), parallel_loader.getDeclaredClasses());
+  EXPECT_EQ(serial_loader.getPluginManifestPath("pluginlib/foo"),
+    parallel_loader.getPluginManifestPath("pluginlib/foo"));
+}
+
+TEST(PluginlibTest, pluginCatalog) {
+  pluginlib::PluginManifest first;
+  first.path = "/first/plugins.xml";
+  first.classes["Fubar"].insert(std::make_pair("pkg/foo",
+    pluginlib::ClassDesc("pkg/foo", "Foo", "Fubar", "pkg", "", "lib/libfoo", first.path)));
+  first.classes["Other"].insert(std::make_pair("pkg/foo",
+    pluginlib::ClassDesc("pkg/foo", "OtherFoo", "Other", "pkg", "", "lib/libfoo", first.path)));
+  pluginlib::PluginManifest second;
+  second.path = "/second/plugins.xml";
+  second.classes["Fubar"].insert(std::make_pair("pkg/foo",
+    pluginlib::ClassDesc("pkg/foo", "Shadowed", "Fubar", "pkg", "", "lib/libbar", second.path)));
+  second.classes["Fubar"].insert(std::make_pair("pkg/bar",
+    pluginlib::ClassDesc("pkg/bar", "Bar", "Fubar", "pkg", "", "lib/libbar", second.path)));
+  std::vector<pluginlib::PluginManifest> manifests;
+  manifests.push_back(first);
+  manifests.push_back(second);
+
+  // Lookup names are per base class, and the first manifest declaring one wins
+  pluginlib::PluginCatalog catalog(manifests);
+  ASSERT_EQ(2u, catalog.getBaseClasses().size());
+  pluginlib::PluginCatalog::ClassMapPtr fubar = catalog.getClasses("Fubar");
+  ASSERT_EQ(2u, fubar->size());
+  EXPECT_STREQ("Foo", fubar->find("pkg/foo").getDerivedClass());
+  EXPECT_STREQ("OtherFoo", catalog.getClasses("Other")->find("pkg/foo").getDerivedClass());
+  EXPECT_TRUE(catalog.getClasses("Unknown")->empty());
+  EXPECT_EQ(fubar, catalog.getClasses("Fubar"));
+
+  // The manifests come back out of the catalog as they went in, shadowed classes included
+  std::vector<pluginlib::PluginManifest> copies = catalog.getManifests();
+  ASSERT_EQ(2u, copies.size());
+  EXPECT_EQ(second.path, copies[1].path);
+  pluginlib::PluginManifest::ClassMap & shadowing = copies[1].classes["Fubar"];
+  ASSERT_EQ(2u, shadowing.size());
+  EXPECT_EQ("Shadowed", shadowing.find("pkg/foo")->second.derived_class_);
+  EXPECT_EQ("UNRESOLVED", shadowing.find("pkg/foo")->second.resolved_library_path_);
+
+  // Loaders of one package and attribute draw their views from one catalog
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  pluginlib::ClassLoaderBase & base_loader = test_loader;
+  pluginlib::PluginCatalog::ConstPtr loader_catalog = base_loader.getPluginCatalog();
+  ASSERT_TRUE(loader_catalog);
+  EXPECT_EQ(test_loader.getDeclaredClasses().size(),
+    loader_catalog->getClasses("test_base::Fubar")->size());
+  pluginlib::ClassLoader<test_base::Fubar> other_loader("pluginlib", "test_base::Fubar");
+  EXPECT_EQ(loader_catalog, other_loader.getPluginCatalog());
+}
+
+TEST(PluginlibTest, classDescStore) {
+  pluginlib::ClassDescStore::Builder builder;
+  std::vector<boost::uint32_t> entries;
+  entries.push_back(builder.add(pluginlib::ClassDesc("pkg/foo", "Foo", "Fubar", "pkg",
+    "Foo plugin", "lib/libplugins", "/pkg/plugins.xml")));
+  entries.push_back(builder.add(pluginlib::ClassDesc("pkg/bar", "Bar", "Fubar", "pkg",
+    "Bar plugin", "lib/libplugins", "/pkg/plugins.xml")));
+  entries.push_back(builder.add(pluginlib::ClassDesc("pkg/foo", "Shadowed", "Fubar", "pkg",
+    "", "lib/libplugins", "/pkg/plugins.xml")));
+  pluginlib::ClassDescStore::ConstPtr store = builder.build();
+  ASSERT_EQ(3u, store->size());
+
+  // Strings the classes share are stored once
+  pluginlib::ClassDescRef foo(*store, store->getEntry(entries[0]));
+  pluginlib::ClassDescRef bar(*store, store->getEntry(entries[1]));
+  EXPECT_EQ(foo.getPackage(), bar.getPackage());
+  EXPECT_EQ(foo.getLibraryName(), bar.getLibraryName());
+  EXPECT_EQ(foo.getPluginManifestPath(), bar.getPluginManifestPath());
+  EXPECT_EQ(foo.getResolvedLibraryPath(), bar.getResolvedLibraryPath());
+  EXPECT_NE(foo.getDescription(), bar.getDescription());
+  pluginlib::ClassDesc desc = foo.toClassDesc();
+  EXPECT_EQ("pkg/foo", desc.lookup_name_);
+  EXPECT_EQ("Foo plugin", desc.description_);
+  EXPECT_EQ("UNRESOLVED", desc.resolved_library_path_);
+
+  // Tables are sorted by lookup name, and keep the first entry of a name
+  pluginlib::ClassDescTable table(store, entries);
+  ASSERT_EQ(2u, table.size());
+  EXPECT_STREQ("pkg/bar", table[0].getLookupName());
+  EXPECT_STREQ("Foo", table.find("pkg/foo").getDerivedClass());
+  EXPECT_FALSE(table.find("pkg/baz").isValid());
+  EXPECT_FALSE(pluginlib::ClassDescTable().find("pkg/foo").isValid());
+
+  std::vector<pluginlib::ClassDescRef> refs;
+  refs.push_back(table[1]);
+  pluginlib::ClassDescTable copy(refs);
+  ASSERT_EQ(1u, copy.size());
+  EXPECT_NE(store, copy.getStore());
+  EXPECT_STREQ("Foo plugin", copy.find("pkg/foo").getDescription());
+}
+
+TEST(PluginlibTest, deferredDescriptions) {
+  boost::filesystem::path manifest_path =
+    boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  std::string xml =
+    "<library path=\"lib/libfoo\">\n"
+    "  <class name=\"pkg/foo\" type=\"Foo\" base_class_type=\"Fubar\">\n"
+    "    <description>This is a foo plugin.</description>\n  </class>\n"
+    "</library>\n";
+  std::ofstream(manifest_path.string().c_str()) << xml;
+  std::vector<pluginlib::PluginXMLClass> classes;
+  ASSERT_TRUE(pluginlib::PluginXMLParser::parseClasses(xml.data(), xml.size(), classes));
+  pluginlib::ClassDesc desc("pkg/foo", "Foo", "Fubar", "pkg", "", "lib/libfoo",
+    manifest_path.string());
+  desc.deferDescription(classes[0].description.data() - xml.data(),
+    classes[0].description.size());
+
+  // Read from the manifest on the first request only
+  std::map<std::string, pluginlib::ClassDesc> descs;
+  descs.insert(std::make_pair(desc.lookup_name_, desc));
+  pluginlib::ClassDescTable table(descs);
+  pluginlib::ClassDescRef foo = table.find("pkg/foo");
+  EXPECT_FALSE(foo.isDescriptionRead());
+  EXPECT_TRUE(foo.toClassDesc().isDescriptionDeferred());
+  EXPECT_STREQ("This is a foo plugin.", foo.getDescription());
+  EXPECT_TRUE(foo.isDescriptionRead());
+
+  // A manifest edited since it was parsed is parsed again
+  std::ofstream(manifest_path.string().c_str()) << "<!-- edited -->\n" << xml;
+  pluginlib::ClassDescTable edited_table(descs);
+  EXPECT_STREQ("This is a foo plugin.", edited_table.find("pkg/foo").getDescription());
+  boost::filesystem::remove(manifest_path);
+  EXPECT_STREQ("This is a foo plugin.", foo.getDescription());
+
+  // Copies of a description already read, as of classes kept by a refresh, keep its text
+  std::vector<pluginlib::ClassDescRef> kept(1, foo);
+  pluginlib::ClassDescTable kept_table(kept);
+  EXPECT_TRUE(kept_table.find("pkg/foo").isDescriptionRead());
+  EXPECT_STREQ("This is a foo plugin.", kept_table.find("pkg/foo").getDescription());
+}
+
+TEST(PluginlibTest, baseClassPrefilter) {
+  const std::string xml =
+    "<library path=\"lib/libfoo\">\n"
+    "  <class type=\"Foo\" base_class_type=\"test_base::Fubar\"/>\n"
+    "  <class type=\"Bar\" base_class_type=\"test::Vector&lt;int&gt;\"/>\n"
+    "</library>\n";
+  EXPECT_TRUE(pluginlib::PluginXMLParser::mayDeclareBaseClass(
+      xml.data(), xml.size(), "test_base::Fubar"));
+  EXPECT_FALSE(pluginlib::PluginXMLParser::mayDeclareBaseClass(
+      xml.data(), xml.size(), "test_base::Other"));
+  EXPECT_TRUE(pluginlib::PluginXMLParser::mayDeclareBaseClass(
+      xml.data(), xml.size(), "test::Vector<int>"));
+
+  // A loader that skips every manifest leaves the shared catalog incomplete for other types
+  pluginlib::ClassLoader<test_base::Fubar> other_loader("pluginlib", "test_base::Other");
+  EXPECT_TRUE(other_loader.getDeclaredClasses().empty());
+  pluginlib::PluginCatalog::ConstPtr catalog = other_loader.getPluginCatalog();
+  EXPECT_TRUE(catalog->isComplete("test_base::Other"));
+  EXPECT_FALSE(catalog->isComplete("test_base::Fubar"));
+
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  EXPECT_TRUE(test_loader.isClassAvailable("pluginlib/foo"));
+  EXPECT_TRUE(test_loader.getPluginCatalog()->isComplete("test_base::Other"));
+  EXPECT_TRUE(test_loader.getPluginCatalog()->isComplete("test_base::Fubar"));
+}
+
+TEST(PluginlibTest, frozenClassTable) {
+  boost::shared_ptr<std::map<std::string, pluginlib::ClassDesc> > classes(
+    new std::map<std::string, pluginlib::ClassDesc>());
+  for (int i = 0; i < 1000; ++i) {
+    std::ostringstream lookup_name;
+    lookup_name << "pkg/plugin_" << i;
+    classes->insert(std::make_pair(lookup_name.str(), pluginlib::ClassDesc(lookup_name.str(),
+      "Plugin", "Base", "pkg", "", "lib/libplugins", "/pkg/plugins.xml")));
+  }
+  pluginlib::FrozenClassTable table(
+    pluginlib::ClassDescTable::ConstPtr(new pluginlib::ClassDescTable(*classes)));
+  ASSERT_EQ(classes->size(), table.size());
+  for (std::map<std::string, pluginlib::ClassDesc>::const_iterator it = classes->begin();
+    it != classes->end(); ++it)
+  {
+    ASSERT_TRUE(table.find(it->first).isValid());
+    EXPECT_EQ(it->first, table.find(it->first).getLookupName());
+    EXPECT_TRUE(table.find(pluginlib::LookupKey(it->first)).isValid());
+  }
+  EXPECT_FALSE(table.find("pkg/plugin_").isValid());
+  EXPECT_FALSE(table.find("").isValid());
+
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  std::vector<std::string> declared_classes = test_loader.getDeclaredClasses();
+  std::string class_type = test_loader.getClassType("pluginlib/foo");
+  test_loader.freeze();
+  EXPECT_TRUE(test_loader.isFrozen());
+  EXPECT_NO_THROW(test_loader.freeze());
+  EXPECT_EQ(declared_classes, test_loader.getDeclaredClasses());
+  EXPECT_EQ(class_type, test_loader.getClassType("pluginlib/foo"));
+  EXPECT_FALSE(test_loader.isClassAvailable("pluginlib/nonexistent"));
+  EXPECT_THROW(test_loader.refreshDeclaredClasses(), pluginlib::ClassLoaderException);
+  EXPECT_FALSE(test_loader.startWatching());
+
+  boost::shared_ptr<test_base::Fubar> foo = test_loader.createInstance("pluginlib/foo");
+  foo->initialize(10.0);
+  EXPECT_EQ(100.0, foo->result());
+}
+
+TEST(PluginlibTest, lookupKey) {
+  std::string lookup_name("pluginlib/foo");
+  pluginlib::LookupKey key(lookup_name);
+  EXPECT_EQ(lookup_name, key.getName());
+  EXPECT_EQ(pluginlib::hashLookupName(lookup_name.data(), lookup_name.size()), key.getHash());
+  for (size_t size = 0; size <= 20; ++size) {
+    std::string name = std::string("pluginlib/fubar_plugin_name").substr(0, size);
+    EXPECT_EQ(pluginlib::hashLookupName(name.data(), name.size()),
+      pluginlib::hashLookupNameAtRuntime(name.data(), name.size()));
+  }
+  EXPECT_NE(key.getHash(), pluginlib::LookupKey(boost::string_view("pluginlib/bar")).getHash());
+#if __cplusplus >= 201103L
+  using namespace pluginlib::literals;  // NOLINT
+  constexpr pluginlib::LookupKey literal_key = "pluginlib/foo"_plugin;
+  constexpr pluginlib::LookupKey nonexistent_key = "pluginlib/nonexistent"_plugin;
+  static_assert(0 != literal_key.getHash(), "The key should be hashed at compile time");
+  EXPECT_EQ(key.getHash(), literal_key.getHash());
+
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  EXPECT_TRUE(test_loader.isClassAvailable(literal_key));
+  EXPECT_FALSE(test_loader.isClassAvailable(nonexistent_key));
+  EXPECT_EQ(test_loader.getClassType("pluginlib/foo"), test_loader.getClassTypeView(literal_key));
+  test_loader.freeze();
+  EXPECT_TRUE(test_loader.isClassAvailable(literal_key));
+  EXPECT_FALSE(test_loader.isClassAvailable(nonexistent_key));
+  EXPECT_THROW(test_loader.createInstance(nonexistent_key), pluginlib::LibraryLoadException);
+
+  boost::shared_ptr<test_base::Fubar> foo = test_loader.createInstance(literal_key);
+  foo->initialize(10.0);
+  EXPECT_EQ(100.0, foo->result());
+#endif
+}
+
+TEST(PluginlibTest, libraryPathCache) {
+  boost::filesystem::path prefix =
+    boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(prefix / "lib");
+  const char * cmake_prefix_path = std::getenv("CMAKE_PREFIX_PATH");
+  std::string saved_cmake_prefix_path = cmake_prefix_path ? cmake_prefix_path : "";
+  setenv("CMAKE_PREFIX_PATH", prefix.string().c_str(), 1);
+
+  std::string library_name = "libpluginlib_library_path_cache_test";
+  std::string library_path =
+    pluginlib::LibraryPathResolver::getAllLibraryPathsToTry(library_name, "").front();
+  pluginlib::LibraryPathCache & cache = pluginlib::LibraryPathCache::instance();
+  cache.clear();
+  EXPECT_EQ("", cache.resolve(library_name, "pluginlib"));
+
+  // Misses are remembered as well as hits, until the cache is cleared
+  std::ofstream(library_path.c_str()) << "";
+  EXPECT_EQ("", cache.resolve(library_name, "pluginlib"));
+  cache.clear();
+  EXPECT_EQ(library_path, cache.resolve(library_name, "pluginlib"));
+  boost::filesystem::remove(library_path);
+  EXPECT_EQ(library_path, cache.resolve(library_name, "pluginlib"));
+
+  // Refreshing any loader clears it
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  test_loader.refreshDeclaredClasses();
+  EXPECT_EQ("", cache.resolve(library_name, "pluginlib"));
+
+  if (cmake_prefix_path) {
+    setenv("CMAKE_PREFIX_PATH", saved_cmake_prefix_path.c_str(), 1);
+  } else {
+    unsetenv("CMAKE_PREFIX_PATH");
+  }
+  cache.clear();
+  boost::filesystem::remove_all(prefix);
+}
+
+TEST(PluginlibTest, resolutionContext) {
+  const char * cmake_prefix_path = std::getenv("CMAKE_PREFIX_PATH");
+  std::string saved_cmake_prefix_path = cmake_prefix_path ? cmake_prefix_path : "";
+  pluginlib::ResolutionContext::ConstPtr context = pluginlib::ResolutionContext::getCurrent();
+  EXPECT_EQ(context, pluginlib::ResolutionContext::getCurrent());
+  EXPECT_EQ(pluginlib::LibraryPathResolver::getCatkinLibraryPaths(),
+    context->getCatkinLibraryPaths());
+  EXPECT_EQ(ros::package::getPath("pluginlib"), context->getPackagePath("pluginlib"));
+  EXPECT_EQ(context->getPackagePath("pluginlib"), context->getPackagePath("pluginlib"));
+
+  // The environment is only read again once the snapshot is invalidated
+  setenv("CMAKE_PREFIX_PATH", "/pluginlib_resolution_context_test", 1);
+  EXPECT_EQ(context->getCatkinLibraryPaths(),
+    pluginlib::ResolutionContext::getCurrent()->getCatkinLibraryPaths());
+  pluginlib::ResolutionContext::invalidate();
+  pluginlib::ResolutionContext::ConstPtr updated_context =
+    pluginlib::ResolutionContext::getCurrent();
+  EXPECT_LT(context->getGeneration(), updated_context->getGeneration());
+  ASSERT_EQ(1u, updated_context->getCatkinLibraryPaths().size());
+  EXPECT_EQ(
+    (boost::filesystem::path("/pluginlib_resolution_context_test") / "lib").string(),
+    updated_context->getCatkinLibraryPaths()[0]);
+
+  if (cmake_prefix_path) {
+    setenv("CMAKE_PREFIX_PATH", saved_cmake_prefix_path.c_str(), 1);
+  } else {
+    unsetenv("CMAKE_PREFIX_PATH");
+  }
+  pluginlib::ResolutionContext::invalidate();
+}
+
+TEST(PluginlibTest, directoryListingCache) {
+  boost::filesystem::path directory =
+    boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  std::string file = (directory / "libplugins.so").string();
+  pluginlib::DirectoryListingCache & cache = pluginlib::DirectoryListingCache::instance();
+  EXPECT_FALSE(cache.exists(file));
+
+  boost::filesystem::create_directories(directory);
+  std::ofstream(file.c_str()) << "";
+  cache.invalidate();
+  EXPECT_TRUE(cache.exists(file));
+  EXPECT_TRUE(cache.exists(directory.string()));
+  EXPECT_FALSE(cache.exists((directory / "libother.so").string()));
+
+  boost::filesystem::create_symlink(directory / "missing", directory / "dangling");
+  cache.invalidate();
+  EXPECT_FALSE(cache.exists((directory / "dangling").string()));
+
+  boost::filesystem::remove(file);
+  cache.invalidate();
+  EXPECT_FALSE(cache.exists(file));
+  boost::filesystem::remove_all(directory);
+
+  // Listings not asked about for a whole generation are dropped
+  cache.invalidate();
+  cache.invalidate();
+  EXPECT_EQ(0u, cache.getDirectoryCount());
+}
+
+TEST(PluginlibTest, packageDirectoryCache) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  std::string manifest_path = test_loader.getPluginManifestPath("pluginlib/foo");
+  ASSERT_FALSE(manifest_path.empty());
+
+  pluginlib::PackageDirectoryCache & cache = pluginlib::PackageDirectoryCache::instance();
+  EXPECT_EQ("pluginlib", cache.getPackageFromPluginXMLFilePath(manifest_path));
+  EXPECT_EQ("pluginlib", cache.getPackageFromPluginXMLFilePath(manifest_path));
+  EXPECT_EQ("", cache.getPackageFromPluginXMLFilePath("/pluginlib_nonexistent/plugins.xml"));
+  cache.clear();
+  EXPECT_EQ("pluginlib", cache.getPackageFromPluginXMLFilePath(manifest_path));
+}
+
+TEST(PluginlibTest, incrementalRefresh) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  std::vector<std::string> declared_classes = test_loader.getDeclaredClasses();
+
+  pluginlib::PluginCatalog::ConstPtr catalog = test_loader.getPluginCatalog();
+  EXPECT_TRUE(test_loader.refreshDeclaredClassesIncremental().empty());
+  EXPECT_EQ(declared_classes, test_loader.getDeclaredClasses());
+  // Nothing changed, so the loader keeps what it had
+  EXPECT_EQ(catalog, test_loader.getPluginCatalog());
+
+  {
+    boost::shared_ptr<test_base::Fubar> foo = test_loader.createInstance("pluginlib/foo");
+    EXPECT_TRUE(test_loader.refreshDeclaredClassesIncremental().empty());
+    EXPECT_TRUE(test_loader.isClassLoaded("pluginlib/foo"));
+  }
+  EXPECT_NO_THROW(test_loader.unloadLibraryForClass("pluginlib/foo"));
+}
+
+TEST(PluginlibTest, nativeDiscovery) {
+  pluginlib::DiscoveryOptions rospack_options;
+  rospack_options.backend = pluginlib::DISCOVERY_BACKEND_ROSPACK;
+  pluginlib::ClassLoader<test_base::Fubar> rospack_loader("pluginlib", "test_base::Fubar",
+    "plugin", std::vector<std::string>(), rospack_options);
+
+  pluginlib::DiscoveryOptions native_options;
+  native_options.backend = pluginlib::DISCOVERY_BACKEND_NATIVE;
+  pluginlib::ClassLoader<test_base::Fubar> native_loader("pluginlib", "test_base::Fubar",
+    "plugin", std::vector<std::string>(), native_options);
+
+  std::vector<std::string> rospack_paths = rospack_loader.getPluginXmlPaths();
+  std::vector<std::string> native_paths = native_loader.getPluginXmlPaths();
+  EXPECT_EQ(std::set<std::string>(rospack_paths.begin(), rospack_paths.end()),
+    std::set<std::string>(native_paths.begin(), native_paths.end()));
+  EXPECT_EQ(rospack_loader.getDeclaredClasses(), native_loader.getDeclaredClasses());
+  EXPECT_EQ(ros::package::getPath("pluginlib"),
+    pluginlib::PackageCrawler::instance().getPath("pluginlib"));
+
+  boost::shared_ptr<test_base::Fubar> foo = native_loader.createInstance("pluginlib/foo");
+  EXPECT_TRUE(native_loader.isClassLoaded("pluginlib/foo"));
+
+  EXPECT_THROW(pluginlib::ClassLoader<test_base::Fubar>("pluginlib_nonexistent",
+    "test_base::Fubar", "plugin", std::vector<std::string>(), native_options),
+    pluginlib::ClassLoaderException);
+}
+
+TEST(PluginlibTest, deferredDiscovery) {
+  pluginlib::DiscoveryOptions options;
+  options.deferred = true;
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar",
+    "plugin", std::vector<std::string>(), options);
+  EXPECT_TRUE(test_loader.isClassAvailable("pluginlib/foo"));
+  EXPECT_TRUE(test_loader.ready().is_ready());
+  EXPECT_NO_THROW(test_loader.ready().get());
+
+  boost::shared_ptr<test_base::Fubar> foo = test_loader.createInstance("pluginlib/foo");
+  foo->initialize(10.0);
+  EXPECT_EQ(100.0, foo->result());
+
+  // Failures surface where the discovery results are needed
+  pluginlib::ClassLoader<test_base::Fubar> bad_loader("pluginlib_nonexistent",
+    "test_base::Fubar", "plugin", std::vector<std::string>(), options);
+  EXPECT_THROW(bad_loader.ready().get(), pluginlib::ClassLoaderException);
+  EXPECT_THROW(bad_loader.getDeclaredClasses(), pluginlib::ClassLoaderException);
+}
+
+TEST(PluginlibTest, batchedFileIO) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  std::vector<std::string> paths = test_loader.getPluginXmlPaths();
+  ASSERT_FALSE(paths.empty());
+  paths.push_back("/pluginlib_nonexistent/plugins.xml");
+
+  pluginlib::BatchedFileIO batched_io;
+  std::vector<pluginlib::ManifestStamp> stamps;
+  std::vector<bool> stamped;
+  if (!batched_io.stamp(paths, stamps, stamped)) {
+    // Kernels without io_uring leave discovery to the usual system calls
+    EXPECT_FALSE(batched_io.isAvailable());
+    return;
+  }
+  std::vector<boost::uint64_t> sizes;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    EXPECT_TRUE(stamped[i]);
+    EXPECT_EQ(pluginlib::ManifestStamp::of(paths[i]), stamps[i]);
+    sizes.push_back(stamps[i].size);
+  }
+
+  std::vector<std::vector<char> > contents;
+  std::vector<bool> read;
+  ASSERT_TRUE(batched_io.read(paths, sizes, contents, read));
+  for (size_t i = 0; i + 1 < paths.size(); ++i) {
+    EXPECT_TRUE(read[i]);
+    std::ifstream file(paths[i].c_str());
+    std::stringstream expected;
+    expected << file.rdbuf();
+    EXPECT_EQ(expected.str(), std::string(contents[i].begin(), contents[i].end()));
+  }
+  EXPECT_FALSE(read.back());
+
+  // A file of another size than expected is left to the caller
+  sizes[0] += 1;
+  ASSERT_TRUE(batched_io.read(paths, sizes, contents, read));
+  EXPECT_FALSE(read[0]);
+
+  pluginlib::DiscoveryOptions options;
+  options.batched_io = true;
+  pluginlib::ClassLoader<test_base::Fubar> batched_loader("pluginlib", "test_base::Fubar",
+    "plugin", std::vector<std::string>(), options);
+  EXPECT_EQ(test_loader.getDeclaredClasses(), batched_loader.getDeclaredClasses());
+  EXPECT_EQ(test_loader.getClassDescription("pluginlib/foo"),
+    batched_loader.getClassDescription("pluginlib/foo"));
+}
+
+TEST(PluginlibTest, pluginXMLParser) {
+  const std::string xml =
+    "<?xml version=\"1.0\"?>\n<!-- plugins -->\n<library path=\"lib/libtest_plugins\">\n"
+    "  <class name=\"pluginlib/foo\" type=\"test_plugins::Foo\" base_class_type=\"Fubar\">\n"
+    "    <description>This is a foo plugin.</description>\n  </class>\n"
+    "  <class type=\"test_plugins::Bar\" base_class_type=\"Fubar\"/>\n</library>\n";
+  std::vector<pluginlib::PluginXMLClass> classes;
+  ASSERT_TRUE(pluginlib::PluginXMLParser::parseClasses(xml.data(), xml.size(), classes));
+  ASSERT_EQ(2u, classes.size());
+  EXPECT_EQ("lib/libtest_plugins", classes[0].library_path);
+  EXPECT_EQ("pluginlib/foo", classes[0].lookup_name);
+  EXPECT_EQ("test_plugins::Foo", classes[0].type);
+  EXPECT_EQ("Fubar", classes[0].base_class_type);
+  EXPECT_EQ("This is a foo plugin.", classes[0].description);
+  EXPECT_FALSE(classes[1].has_lookup_name);
+  EXPECT_FALSE(classes[1].has_description);
+
+  // Anything needing more than views into the buffer is left to tinyxml2
+  const std::string escaped =
+    "<library path=\"lib/a\"><class type=\"A&lt;B&gt;\" base_class_type=\"C\"/></library>";
+  classes.clear();
+  EXPECT_FALSE(pluginlib::PluginXMLParser::parseClasses(escaped.data(), escaped.size(), classes));
+  EXPECT_TRUE(classes.empty());
+  const std::string cdata =
+    "<library path=\"lib/a\"><class type=\"A\" base_class_type=\"C\">"
+    "<description><![CDATA[A <b>bold</b> plugin.]]></description></class></library>";
+  classes.clear();
+  EXPECT_FALSE(pluginlib::PluginXMLParser::parseClasses(cdata.data(), cdata.size(), classes));
+
+  // The loader still gets every class from test_plugins.xml
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  EXPECT_EQ("This is a foo plugin.", test_loader.getClassDescription("pluginlib/foo"));
+  EXPECT_EQ("test_plugins::Bar", test_loader.getClassType("pluginlib/bar"));
+}
+
+TEST(PluginlibTest, workspaceIndex) {
+  std::vector<std::string> crawled_classes;
+  std::string crawled_library;
+  {
+    pluginlib::ClassLoader<test_base::Fubar> crawled_loader("pluginlib", "test_base::Fubar");
+    crawled_classes = crawled_loader.getDeclaredClasses();
+    crawled_library = crawled_loader.getClassLibraryPath("pluginlib/foo");
+  }
+
+  boost::filesystem::path index_path =
+    boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  pluginlib::WorkspaceIndex::ConstPtr index = pluginlib::WorkspaceIndex::build();
+  {
+    std::ofstream index_file(index_path.string().c_str());
+    ASSERT_TRUE(index->write(index_file));
+  }
+  pluginlib::WorkspaceIndex::ConstPtr loaded = pluginlib::WorkspaceIndex::load(index_path.string());
+  ASSERT_TRUE(loaded);
+  std::ostringstream written, rewritten;
+  index->write(written);
+  loaded->write(rewritten);
+  EXPECT_EQ(written.str(), rewritten.str());
+
+  setenv("PLUGINLIB_INDEX", index_path.string().c_str(), 1);
+  ASSERT_TRUE(pluginlib::WorkspaceIndex::getActive());
+  {
+    pluginlib::ClassLoader<test_base::Fubar> indexed_loader("pluginlib", "test_base::Fubar");
+    EXPECT_EQ(crawled_classes, indexed_loader.getDeclaredClasses());
+    EXPECT_EQ(crawled_library, indexed_loader.getClassLibraryPath("pluginlib/foo"));
+    EXPECT_EQ("This is a foo plugin.", indexed_loader.getClassDescription("pluginlib/foo"));
+    boost::shared_ptr<test_base::Fubar> foo = indexed_loader.createInstance("pluginlib/foo");
+    foo->initialize(10.0);
+    EXPECT_EQ(100.0, foo->result());
+  }
+  unsetenv("PLUGINLIB_INDEX");
+  EXPECT_FALSE(pluginlib::WorkspaceIndex::getActive());
+  boost::filesystem::remove(index_path);
+}
+
+TEST(PluginlibTest, watchPlugins) {
+  pluginlib::ClassLoader<test_base::Fubar> test_loader("pluginlib", "test_base::Fubar");
+  EXPECT_FALSE(test_loader.isWatching());
+
+  bool supported = test_loader.startWatching();
+  EXPECT_EQ(supported, test_loader.isWatching());
+  EXPECT_EQ(supported, test_loader.startWatching());
+  EXPECT_TRUE(test_loader.isClassAvailable("pluginlib/foo"));
+
+  test_loader.stopWatching();
+  EXPECT_FALSE(test_loader.isWatching());
+  test_loader.stopWatching();
+}
+
 // Run all the tests that were declared with TEST()
 int main(int argc, char ** argv)
 {